@@ -0,0 +1,585 @@
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "geometry.hpp"
+
+using namespace Geometry;
+
+// Every fast path is checked against the plain predicates on its own
+// queries before it is timed; a benchmark whose answers differ stops with
+// an error instead of reporting a time.
+
+namespace {
+
+int Uniform(std::mt19937& rng, int lo, int hi) {
+  return std::uniform_int_distribution<int>(lo, hi)(rng);
+}
+
+Polygon MakePolygon(std::mt19937& rng, int cx, int cy, int size) {
+  std::vector<Point> points;
+  for (int i = Uniform(rng, 3, 8); i > 0; i--) {
+    points.emplace_back(cx + Uniform(rng, -size, size),
+                        cy + Uniform(rng, -size, size));
+  }
+  return Polygon(points);
+}
+
+// Alternating radii 600 and 1000 around the origin; non-convex.
+Polygon MakeStar(int vertices) {
+  std::vector<Point> points;
+  for (int i = 0; i < vertices; i++) {
+    double angle = 2 * M_PI * i / vertices;
+    double radius = (i % 2 == 0 ? 600 : 1000);
+    points.emplace_back(std::lround(radius * std::cos(angle)),
+                        std::lround(radius * std::sin(angle)));
+  }
+  return Polygon(points);
+}
+
+Polygon MakeRegular(int vertices) {
+  std::vector<Point> points;
+  for (int i = 0; i < vertices; i++) {
+    double angle = 2 * M_PI * i / vertices;
+    points.emplace_back(std::lround(1e5 * std::cos(angle)),
+                        std::lround(1e5 * std::sin(angle)));
+  }
+  return Polygon(points);
+}
+
+std::vector<Point> MakePoints(size_t count, int range) {
+  std::mt19937 rng(1);
+  std::vector<Point> points;
+  for (size_t i = 0; i < count; i++) {
+    points.emplace_back(Uniform(rng, -range, range),
+                        Uniform(rng, -range, range));
+  }
+  return points;
+}
+
+// Random polygons on a small grid, most of them with collinear edges,
+// repeated vertices or crossings, against Polygon on every grid point.
+bool RandomPolygonsMatch() {
+  std::mt19937 rng(4);
+  for (int i = 0; i < 2000; i++) {
+    int range = Uniform(rng, 1, 6);
+    Polygon polygon = MakePolygon(rng, 0, 0, range);
+    PreparedPolygon prepared(polygon);
+    for (int x = -range - 1; x <= range + 1; x++) {
+      for (int y = -range - 1; y <= range + 1; y++) {
+        if (prepared.ContainsPoint(Point(x, y)) !=
+            polygon.ContainsPoint(Point(x, y))) {
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+Polygon MakeBenchPolygon(benchmark::State& state) {
+  return (state.range(1) == 1 ? MakeRegular(state.range(0))
+                              : MakeStar(state.range(0)));
+}
+
+std::vector<Segment> MakeSegments(size_t count, int range, int length) {
+  std::mt19937 rng(2);
+  std::vector<Segment> segments;
+  for (size_t i = 0; i < count; i++) {
+    int x = Uniform(rng, -range, range);
+    int y = Uniform(rng, -range, range);
+    segments.emplace_back(Point(x, y),
+                          Point(x + Uniform(rng, -length, length),
+                                y + Uniform(rng, -length, length)));
+  }
+  return segments;
+}
+
+// The shapes the batch kernels specialize, by benchmark argument.
+std::unique_ptr<IShape> MakeBatchShape(benchmark::State& state) {
+  switch (state.range(0)) {
+    case 0:
+      state.SetLabel("Circle");
+      return std::make_unique<Circle>(Point(10, 20), 700);
+    case 1:
+      state.SetLabel("Line");
+      return std::make_unique<Line>(Point(0, 0), Point(3, 7));
+    case 2:
+      state.SetLabel("Ray");
+      return std::make_unique<Ray>(Point(0, 0), Point(3, 7));
+    case 3:
+      state.SetLabel("Segment");
+      return std::make_unique<Segment>(Point(-900, -800), Point(900, 1000));
+    default:
+      state.SetLabel("Polygon");
+      return std::make_unique<Polygon>(MakeStar(16));
+  }
+}
+
+// Small shapes of every type scattered over a square that grows with
+// their count, so that a query meets about as many of them at every
+// size. One in a thousand is a Line or a Ray, which ShapeIndex tests on
+// every query.
+struct Scene {
+  explicit Scene(size_t count);
+
+  std::vector<std::unique_ptr<IShape>> owned;
+  std::vector<IShape*> shapes;
+  std::vector<Point> points;
+  std::vector<Segment> segments;
+};
+
+Scene::Scene(size_t count) {
+  std::mt19937 rng(3);
+  int world = std::sqrt((double)count) * 40;
+  for (size_t i = 0; i < count; i++) {
+    int cx = Uniform(rng, -world, world);
+    int cy = Uniform(rng, -world, world);
+    int size = Uniform(rng, 1, 30);
+    Point center(cx, cy);
+    Point other(cx + Uniform(rng, -size, size), cy + Uniform(rng, -size, size));
+    IShape* shape = nullptr;
+    if (i % 1000 == 10) {
+      shape = new Line(center, Point(cx + 1, cy + Uniform(rng, -3, 3)));
+    } else if (i % 1000 == 11) {
+      shape = new Ray(center, Point(cx + Uniform(rng, -3, 3), cy + 1));
+    } else if (i % 20 == 0) {
+      shape = new Point(center);
+    } else if (i % 20 < 5) {
+      shape = new Segment(center, other);
+    } else if (i % 20 < 10) {
+      shape = new Circle(center, size);
+    } else if (i % 7 == 0) {
+      shape = new PreparedPolygon(MakePolygon(rng, cx, cy, size));
+    } else {
+      shape = new Polygon(MakePolygon(rng, cx, cy, size));
+    }
+    owned.emplace_back(shape);
+    shapes.push_back(shape);
+  }
+  points = MakePoints(1024, world);
+  segments = MakeSegments(1024, world, 100);
+}
+
+std::vector<size_t> ScanContaining(const std::vector<IShape*>& shapes,
+                                   const Point& point) {
+  std::vector<size_t> res;
+  for (size_t i = 0; i < shapes.size(); i++) {
+    if (shapes[i]->ContainsPoint(point)) {
+      res.push_back(i);
+    }
+  }
+  return res;
+}
+
+std::vector<size_t> ScanCrossing(const std::vector<IShape*>& shapes,
+                                 const Segment& seg) {
+  std::vector<size_t> res;
+  for (size_t i = 0; i < shapes.size(); i++) {
+    if (shapes[i]->CrossesSegment(seg)) {
+      res.push_back(i);
+    }
+  }
+  return res;
+}
+
+// The first queries of the scene, plus degenerate segments, against the
+// linear scan.
+bool IndexMatchesScan(const Scene& scene, const ShapeIndex& index) {
+  for (size_t i = 0; i < 64; i++) {
+    const Point& point = scene.points[i];
+    const Segment& seg = scene.segments[i];
+    if (index.ShapesContaining(point) != ScanContaining(scene.shapes, point) ||
+        index.ShapesCrossing(seg) != ScanCrossing(scene.shapes, seg) ||
+        index.ShapesCrossing(Segment(point, point)) !=
+            ScanCrossing(scene.shapes, Segment(point, point))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Mixed shapes of every type but PreparedPolygon, both as values and as
+// clones behind IShape pointers, with the circles and polygons also kept
+// by type.
+struct Shapes {
+  Shapes();
+
+  std::vector<Shape> values;
+  std::vector<std::unique_ptr<IShape>> clones;
+  ShapeVector<Circle> circles;
+  std::vector<std::unique_ptr<IShape>> circle_clones;
+  ShapeVector<Polygon> polygons;
+  std::vector<std::unique_ptr<IShape>> polygon_clones;
+  std::vector<Point> points;
+};
+
+Shapes::Shapes() {
+  std::mt19937 rng(5);
+  int world = 3000;
+  for (int i = 0; i < 20000; i++) {
+    int cx = Uniform(rng, -world, world);
+    int cy = Uniform(rng, -world, world);
+    int size = Uniform(rng, 1, 60);
+    Point center(cx, cy);
+    switch (i % 6) {
+      case 0:
+        values.emplace_back(center);
+        break;
+      case 1:
+        values.emplace_back(Segment(
+            center, Point(cx + Uniform(rng, -size, size),
+                          cy + Uniform(rng, -size, size))));
+        break;
+      case 2:
+        values.emplace_back(
+            Line(center, Point(cx + 1, cy + Uniform(rng, -3, 3))));
+        break;
+      case 3:
+        values.emplace_back(
+            Ray(center, Point(cx + Uniform(rng, -3, 3), cy + 1)));
+        break;
+      case 4: {
+        Circle circle(center, size);
+        circles.Push(circle);
+        circle_clones.emplace_back(circle.Clone());
+        values.emplace_back(circle);
+        break;
+      }
+      default: {
+        Polygon polygon = MakePolygon(rng, cx, cy, size);
+        polygons.Push(polygon);
+        polygon_clones.emplace_back(polygon.Clone());
+        values.emplace_back(polygon);
+      }
+    }
+    clones.emplace_back(std::visit(
+        [](const auto& shape) -> IShape* { return shape.Clone(); },
+        values.back().GetVariant()));
+  }
+  points = MakePoints(256, world);
+}
+
+const Shapes& GetShapes() {
+  static const Shapes kShapes;
+  return kShapes;
+}
+
+size_t CountContaining(const std::vector<std::unique_ptr<IShape>>& shapes,
+                       const Point& point) {
+  size_t count = 0;
+  for (const auto& shape : shapes) {
+    count += shape->ContainsPoint(point);
+  }
+  return count;
+}
+
+size_t CountContaining(const std::vector<Shape>& shapes, const Point& point) {
+  size_t count = 0;
+  for (const Shape& shape : shapes) {
+    count += shape.ContainsPoint(point);
+  }
+  return count;
+}
+
+bool ValuesMatchClones(const Shapes& shapes) {
+  for (const Point& point : shapes.points) {
+    if (CountContaining(shapes.values, point) !=
+            CountContaining(shapes.clones, point) ||
+        shapes.circles.ShapesContaining(point).size() !=
+            CountContaining(shapes.circle_clones, point) ||
+        shapes.polygons.ShapesContaining(point).size() !=
+            CountContaining(shapes.polygon_clones, point)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+////////////////////////////////PreparedPolygon/////////////////////////////////
+// Arguments: the number of vertices, and 1 for a convex polygon or 0 for
+// a star.
+void BM_ContainsPoint_Polygon(benchmark::State& state) {
+  Polygon polygon = MakeBenchPolygon(state);
+  std::vector<Point> points =
+      MakePoints(4096, state.range(1) == 1 ? 100000 : 1000);
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        polygon.ContainsPoint(points[i++ % points.size()]));
+  }
+}
+BENCHMARK(BM_ContainsPoint_Polygon)
+    ->ArgsProduct({{8, 64, 1024, 16384}, {0, 1}});
+
+void BM_ContainsPoint_PreparedPolygon(benchmark::State& state) {
+  static const bool kRandomPolygonsMatch = RandomPolygonsMatch();
+  Polygon polygon = MakeBenchPolygon(state);
+  PreparedPolygon prepared(polygon);
+  std::vector<Point> points =
+      MakePoints(4096, state.range(1) == 1 ? 100000 : 1000);
+  if (!kRandomPolygonsMatch) {
+    state.SkipWithError("PreparedPolygon differs from Polygon");
+    return;
+  }
+  for (const Point& point : points) {
+    if (prepared.ContainsPoint(point) != polygon.ContainsPoint(point)) {
+      state.SkipWithError("PreparedPolygon differs from Polygon");
+      return;
+    }
+  }
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        prepared.ContainsPoint(points[i++ % points.size()]));
+  }
+}
+BENCHMARK(BM_ContainsPoint_PreparedPolygon)
+    ->ArgsProduct({{8, 64, 1024, 16384}, {0, 1}});
+
+void BM_Prepare_PreparedPolygon(benchmark::State& state) {
+  Polygon polygon = MakeBenchPolygon(state);
+  for (auto _ : state) {
+    PreparedPolygon prepared(polygon);
+    benchmark::DoNotOptimize(&prepared);
+  }
+}
+BENCHMARK(BM_Prepare_PreparedPolygon)
+    ->ArgsProduct({{8, 64, 1024, 16384}, {0, 1}});
+
+///////////////////////////////////////Batch////////////////////////////////////
+// The argument picks the shape: Circle, Line, Ray, Segment or a 16-vertex
+// Polygon.
+void BM_ContainsPoints_Scalar(benchmark::State& state) {
+  std::unique_ptr<IShape> shape = MakeBatchShape(state);
+  std::vector<Point> points = MakePoints(1 << 16, 1000);
+  std::vector<uint8_t> out(points.size());
+  for (auto _ : state) {
+    for (size_t i = 0; i < points.size(); i++) {
+      out[i] = shape->ContainsPoint(points[i]);
+    }
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetItemsProcessed(state.iterations() * points.size());
+}
+BENCHMARK(BM_ContainsPoints_Scalar)->DenseRange(0, 4);
+
+void BM_ContainsPoints_Batch(benchmark::State& state) {
+  std::unique_ptr<IShape> shape = MakeBatchShape(state);
+  std::vector<Point> points = MakePoints(1 << 16, 1000);
+  PointBuffer buffer;
+  for (const Point& point : points) {
+    buffer.Push(point.coordinate);
+  }
+  std::vector<uint8_t> out(points.size());
+  shape->ContainsPoints(buffer, out);
+  for (size_t i = 0; i < points.size(); i++) {
+    if (out[i] != shape->ContainsPoint(points[i])) {
+      state.SkipWithError("ContainsPoints differs from ContainsPoint");
+      return;
+    }
+  }
+  for (auto _ : state) {
+    shape->ContainsPoints(buffer, out);
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetItemsProcessed(state.iterations() * points.size());
+}
+BENCHMARK(BM_ContainsPoints_Batch)->DenseRange(0, 4);
+
+void BM_CrossesSegments_Scalar(benchmark::State& state) {
+  std::unique_ptr<IShape> shape = MakeBatchShape(state);
+  std::vector<Segment> segments = MakeSegments(1 << 14, 1000, 1000);
+  std::vector<uint8_t> out(segments.size());
+  for (auto _ : state) {
+    for (size_t i = 0; i < segments.size(); i++) {
+      out[i] = shape->CrossesSegment(segments[i]);
+    }
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetItemsProcessed(state.iterations() * segments.size());
+}
+BENCHMARK(BM_CrossesSegments_Scalar)->DenseRange(0, 4);
+
+void BM_CrossesSegments_Batch(benchmark::State& state) {
+  std::unique_ptr<IShape> shape = MakeBatchShape(state);
+  std::vector<Segment> segments = MakeSegments(1 << 14, 1000, 1000);
+  SegmentBuffer buffer(segments);
+  std::vector<uint8_t> out(segments.size());
+  shape->CrossesSegments(buffer, out);
+  for (size_t i = 0; i < segments.size(); i++) {
+    if (out[i] != shape->CrossesSegment(segments[i])) {
+      state.SkipWithError("CrossesSegments differs from CrossesSegment");
+      return;
+    }
+  }
+  for (auto _ : state) {
+    shape->CrossesSegments(buffer, out);
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetItemsProcessed(state.iterations() * segments.size());
+}
+BENCHMARK(BM_CrossesSegments_Batch)->DenseRange(0, 4);
+
+////////////////////////////////////ShapeIndex//////////////////////////////////
+void BM_BuildShapeIndex(benchmark::State& state) {
+  Scene scene(state.range(0));
+  for (auto _ : state) {
+    ShapeIndex index(scene.shapes);
+    benchmark::DoNotOptimize(index.Size());
+  }
+}
+BENCHMARK(BM_BuildShapeIndex)
+    ->RangeMultiplier(4)
+    ->Range(1 << 10, 1 << 16)
+    ->Unit(benchmark::kMillisecond);
+
+void BM_ShapesContaining_Index(benchmark::State& state) {
+  Scene scene(state.range(0));
+  ShapeIndex index(scene.shapes);
+  if (!IndexMatchesScan(scene, index)) {
+    state.SkipWithError("ShapeIndex differs from the linear scan");
+    return;
+  }
+  size_t i = 0;
+  for (auto _ : state) {
+    std::vector<size_t> res =
+        index.ShapesContaining(scene.points[i++ % scene.points.size()]);
+    benchmark::DoNotOptimize(res.data());
+  }
+}
+BENCHMARK(BM_ShapesContaining_Index)
+    ->RangeMultiplier(4)
+    ->Range(1 << 10, 1 << 16);
+
+void BM_ShapesContaining_Scan(benchmark::State& state) {
+  Scene scene(state.range(0));
+  size_t i = 0;
+  for (auto _ : state) {
+    std::vector<size_t> res = ScanContaining(
+        scene.shapes, scene.points[i++ % scene.points.size()]);
+    benchmark::DoNotOptimize(res.data());
+  }
+}
+BENCHMARK(BM_ShapesContaining_Scan)
+    ->RangeMultiplier(4)
+    ->Range(1 << 10, 1 << 16);
+
+void BM_ShapesCrossing_Index(benchmark::State& state) {
+  Scene scene(state.range(0));
+  ShapeIndex index(scene.shapes);
+  if (!IndexMatchesScan(scene, index)) {
+    state.SkipWithError("ShapeIndex differs from the linear scan");
+    return;
+  }
+  size_t i = 0;
+  for (auto _ : state) {
+    std::vector<size_t> res = index.ShapesCrossing(
+        scene.segments[i++ % scene.segments.size()]);
+    benchmark::DoNotOptimize(res.data());
+  }
+}
+BENCHMARK(BM_ShapesCrossing_Index)
+    ->RangeMultiplier(4)
+    ->Range(1 << 10, 1 << 16);
+
+void BM_ShapesCrossing_Scan(benchmark::State& state) {
+  Scene scene(state.range(0));
+  size_t i = 0;
+  for (auto _ : state) {
+    std::vector<size_t> res = ScanCrossing(
+        scene.shapes, scene.segments[i++ % scene.segments.size()]);
+    benchmark::DoNotOptimize(res.data());
+  }
+}
+BENCHMARK(BM_ShapesCrossing_Scan)
+    ->RangeMultiplier(4)
+    ->Range(1 << 10, 1 << 16);
+
+///////////////////////////////////////Shape////////////////////////////////////
+void BM_Mixed_IShape(benchmark::State& state) {
+  const Shapes& shapes = GetShapes();
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(CountContaining(
+        shapes.clones, shapes.points[i++ % shapes.points.size()]));
+  }
+  state.SetItemsProcessed(state.iterations() * shapes.clones.size());
+}
+BENCHMARK(BM_Mixed_IShape);
+
+void BM_Mixed_Shape(benchmark::State& state) {
+  const Shapes& shapes = GetShapes();
+  if (!ValuesMatchClones(shapes)) {
+    state.SkipWithError("Shape differs from IShape");
+    return;
+  }
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(CountContaining(
+        shapes.values, shapes.points[i++ % shapes.points.size()]));
+  }
+  state.SetItemsProcessed(state.iterations() * shapes.values.size());
+}
+BENCHMARK(BM_Mixed_Shape);
+
+void BM_Circles_IShape(benchmark::State& state) {
+  const Shapes& shapes = GetShapes();
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(CountContaining(
+        shapes.circle_clones, shapes.points[i++ % shapes.points.size()]));
+  }
+  state.SetItemsProcessed(state.iterations() * shapes.circle_clones.size());
+}
+BENCHMARK(BM_Circles_IShape);
+
+void BM_Circles_ShapeVector(benchmark::State& state) {
+  const Shapes& shapes = GetShapes();
+  if (!ValuesMatchClones(shapes)) {
+    state.SkipWithError("ShapeVector differs from IShape");
+    return;
+  }
+  size_t i = 0;
+  for (auto _ : state) {
+    std::vector<size_t> res = shapes.circles.ShapesContaining(
+        shapes.points[i++ % shapes.points.size()]);
+    benchmark::DoNotOptimize(res.data());
+  }
+  state.SetItemsProcessed(state.iterations() * shapes.circles.Size());
+}
+BENCHMARK(BM_Circles_ShapeVector);
+
+void BM_Polygons_IShape(benchmark::State& state) {
+  const Shapes& shapes = GetShapes();
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(CountContaining(
+        shapes.polygon_clones, shapes.points[i++ % shapes.points.size()]));
+  }
+  state.SetItemsProcessed(state.iterations() * shapes.polygon_clones.size());
+}
+BENCHMARK(BM_Polygons_IShape);
+
+void BM_Polygons_ShapeVector(benchmark::State& state) {
+  const Shapes& shapes = GetShapes();
+  if (!ValuesMatchClones(shapes)) {
+    state.SkipWithError("ShapeVector differs from IShape");
+    return;
+  }
+  size_t i = 0;
+  for (auto _ : state) {
+    std::vector<size_t> res = shapes.polygons.ShapesContaining(
+        shapes.points[i++ % shapes.points.size()]);
+    benchmark::DoNotOptimize(res.data());
+  }
+  state.SetItemsProcessed(state.iterations() * shapes.polygons.Size());
+}
+BENCHMARK(BM_Polygons_ShapeVector);
+
+BENCHMARK_MAIN();
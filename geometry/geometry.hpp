@@ -1,10 +1,24 @@
+#include <charconv>
 #include <cmath>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <iostream>
+#include <limits>
 #include <memory>
+#include <memory_resource>
+#include <optional>
+#include <span>
 #include <string>
+#include <type_traits>
 #include <utility>
+#include <variant>
 #include <vector>
 
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
 namespace Geometry {
 
   class Vector;
@@ -23,6 +37,21 @@ namespace Geometry {
 
   class Polygon;
 
+  class PreparedPolygon;
+
+  struct PointBuffer;
+
+  struct SegmentBuffer;
+
+  struct Box;
+
+  class ShapeIndex;
+
+  class Shape;
+
+  template <typename T>
+  class ShapeVector;
+
   template <typename T>
   int Sign(T x) {
     return (x == 0 ? 0 : x / std::abs(x));
@@ -39,6 +68,16 @@ namespace Geometry {
     return 0;
   }
 
+  // ToString appends numbers with std::to_chars into one preallocated
+  // string instead of concatenating std::to_string temporaries.
+  void AppendNumber(std::string& output, long long value) {
+    char buffer[24];
+    output.append(buffer,
+                  std::to_chars(buffer, buffer + sizeof(buffer), value).ptr);
+  }
+
+  void AppendPoint(std::string& output, const Vector& coordinate);
+
   class Vector {
    public:
     Vector() { x = y = 0; }
@@ -75,7 +114,7 @@ namespace Geometry {
 
 /////////////////////////Vector/////////////////////////
   long long operator*(const Vector& l, const Vector& r) {
-    return l.x * r.x + l.y * r.y;
+    return (long long)l.x * r.x + (long long)l.y * r.y;
   }
 
   Vector operator*(const Vector& l, int value) {
@@ -87,7 +126,7 @@ namespace Geometry {
   }
 
   long long operator^(const Vector& l, const Vector& r) {
-    return l.x * r.y - l.y * r.x;
+    return (long long)l.x * r.y - (long long)l.y * r.x;
   }
 
   Vector operator+(const Vector& l, const Vector& r) {
@@ -109,6 +148,72 @@ namespace Geometry {
     return out;
   }
 
+  // Cross product of b - a and c - a in 64 bits: positive when c lies to
+  // the left of the directed line a -> b.
+  long long Cross(const Vector& a, const Vector& b, const Vector& c) {
+    return (long long)(b.x - a.x) * (c.y - a.y) -
+           (long long)(b.y - a.y) * (c.x - a.x);
+  }
+
+  bool OnSegment(const Vector& a, const Vector& b, const Vector& point) {
+    return Cross(a, b, point) == 0 && std::min(a.x, b.x) <= point.x &&
+           point.x <= std::max(a.x, b.x) && std::min(a.y, b.y) <= point.y &&
+           point.y <= std::max(a.y, b.y);
+  }
+
+  // Coordinates of many points, x and y in separate arrays, so that the
+  // batch queries load consecutive points straight into vector registers.
+  struct PointBuffer {
+    PointBuffer() = default;
+
+    explicit PointBuffer(std::span<const Vector> points);
+
+    void Push(const Vector& point);
+
+    size_t Size() const;
+
+    std::vector<int> x;
+    std::vector<int> y;
+  };
+
+  // Segments from (x1, y1) to (x2, y2), laid out like PointBuffer.
+  struct SegmentBuffer {
+    SegmentBuffer() = default;
+
+    explicit SegmentBuffer(std::span<const Segment> segments);
+
+    void Push(const Segment& segment);
+
+    size_t Size() const;
+
+    std::vector<int> x1;
+    std::vector<int> y1;
+    std::vector<int> x2;
+    std::vector<int> y2;
+  };
+
+  // Axis-aligned box, borders included; empty until extended.
+  struct Box {
+    void Extend(const Vector& point);
+
+    void Extend(const Box& box);
+
+    bool Empty() const;
+
+    bool ContainsPoint(const Vector& point) const;
+
+    bool Intersects(const Box& box) const;
+
+    // Whether the segment a b has a point in the box, exactly: the boxes
+    // overlap and the corners are not all strictly on one side of a b.
+    bool CrossesSegment(const Vector& a, const Vector& b) const;
+
+    int min_x = std::numeric_limits<int>::max();
+    int min_y = std::numeric_limits<int>::max();
+    int max_x = std::numeric_limits<int>::min();
+    int max_y = std::numeric_limits<int>::min();
+  };
+
   class IShape {
    public:
     virtual ~IShape() = default;
@@ -119,12 +224,26 @@ namespace Geometry {
 
     virtual bool CrossesSegment(const Segment&) const = 0;
 
+    // out[i] = ContainsPoint(i-th point) for the whole buffer, one virtual
+    // call per batch; out must hold points.Size() elements. The default
+    // loops over ContainsPoint, the shapes override it with AVX2 kernels.
+    virtual void ContainsPoints(const PointBuffer& points,
+                                std::span<uint8_t> out) const;
+
+    // out[i] = CrossesSegment(i-th segment), as ContainsPoints.
+    virtual void CrossesSegments(const SegmentBuffer& segments,
+                                 std::span<uint8_t> out) const;
+
+    // Box around every point the shape contains or crosses a segment at;
+    // std::nullopt for the unbounded Line and Ray.
+    virtual std::optional<Box> BoundingBox() const = 0;
+
     virtual IShape* Clone() const = 0;
 
     virtual std::string ToString() const = 0;
   };
 
-  class Point : public IShape {
+  class Point final : public IShape {
    public:
     Point() = default;
 
@@ -142,10 +261,12 @@ namespace Geometry {
 
     IShape* Clone() const override;
 
+    std::optional<Box> BoundingBox() const override;
+
     Vector coordinate;
   };
 
-  class Segment : public IShape {
+  class Segment final : public IShape {
    public:
     Segment() = default;
 
@@ -161,10 +282,18 @@ namespace Geometry {
 
     bool CrossesSegment(const Segment& seg) const override;
 
+    void ContainsPoints(const PointBuffer& points,
+                        std::span<uint8_t> out) const override;
+
+    void CrossesSegments(const SegmentBuffer& segments,
+                         std::span<uint8_t> out) const override;
+
     std::string ToString() const override;
 
     IShape* Clone() const override;
 
+    std::optional<Box> BoundingBox() const override;
+
     Point GetL() const;
 
     Point GetR() const;
@@ -174,7 +303,7 @@ namespace Geometry {
     Point r_;
   };
 
-  class Line : public IShape {
+  class Line final : public IShape {
    public:
     Line() = default;
 
@@ -188,10 +317,18 @@ namespace Geometry {
 
     bool CrossesSegment(const Segment& seg) const override;
 
+    void ContainsPoints(const PointBuffer& points,
+                        std::span<uint8_t> out) const override;
+
+    void CrossesSegments(const SegmentBuffer& segments,
+                         std::span<uint8_t> out) const override;
+
     std::string ToString() const override;
 
     IShape* Clone() const override;
 
+    std::optional<Box> BoundingBox() const override;
+
    private:
     Point l_;
     Point r_;
@@ -200,7 +337,7 @@ namespace Geometry {
     int c_ = 0;
   };
 
-  class Ray : public IShape {
+  class Ray final : public IShape {
    public:
     Ray() = default;
 
@@ -214,20 +351,39 @@ namespace Geometry {
 
     bool CrossesSegment(const Segment& seg) const override;
 
+    void ContainsPoints(const PointBuffer& points,
+                        std::span<uint8_t> out) const override;
+
+    void CrossesSegments(const SegmentBuffer& segments,
+                         std::span<uint8_t> out) const override;
+
     std::string ToString() const override;
 
     IShape* Clone() const override;
 
+    std::optional<Box> BoundingBox() const override;
+
    private:
     Point point_;
     Vector vector_;
   };
 
-  class Polygon : public IShape {
+  class Polygon final : public IShape {
    public:
     Polygon() = default;
 
-    explicit Polygon(std::vector<Point> points);
+    // The vertices are copied once, straight into memory from resource,
+    // the default resource if it is nullptr.
+    explicit Polygon(const std::vector<Point>& points,
+                     std::pmr::memory_resource* resource = nullptr);
+
+    Polygon(const Polygon& other, std::pmr::memory_resource* resource);
+
+    Polygon(const Polygon& other) = default;
+
+    // Keeps the resource of other, so polygons in a pool stay there when
+    // a std::vector of them grows.
+    Polygon(Polygon&& other) = default;
 
     Polygon& operator=(const Polygon& other) = default;
 
@@ -237,15 +393,25 @@ namespace Geometry {
 
     bool CrossesSegment(const Segment& seg) const override;
 
+    void ContainsPoints(const PointBuffer& points,
+                        std::span<uint8_t> out) const override;
+
+    void CrossesSegments(const SegmentBuffer& segments,
+                         std::span<uint8_t> out) const override;
+
     std::string ToString() const override;
 
     IShape* Clone() const override;
 
+    std::optional<Box> BoundingBox() const override;
+
+    std::span<const Point> GetPoints() const;
+
    private:
-    std::vector<Point> points_;
+    std::pmr::vector<Point> points_;
   };
 
-  class Circle : public IShape {
+  class Circle final : public IShape {
    public:
     Circle() = default;
 
@@ -259,15 +425,668 @@ namespace Geometry {
 
     bool CrossesSegment(const Segment& seg) const override;
 
+    void ContainsPoints(const PointBuffer& points,
+                        std::span<uint8_t> out) const override;
+
+    void CrossesSegments(const SegmentBuffer& segments,
+                         std::span<uint8_t> out) const override;
+
     std::string ToString() const override;
 
     IShape* Clone() const override;
 
+    std::optional<Box> BoundingBox() const override;
+
    private:
     Point center_;
     int radius_ = 0;
   };
 
+  // Polygon preprocessed once for many ContainsPoint queries, answered in
+  // O(log n) with exact integer arithmetic; the boundary counts as inside,
+  // as in Polygon::ContainsPoint.
+  //
+  // Convex polygons are searched by a binary search over the triangle fan
+  // around their first vertex. Other polygons are cut into vertical slabs
+  // at the x of every vertex: a binary search finds the slab, and a
+  // descent of its tree the number of edges below the point among the
+  // edges crossing the slab, which never cross each other inside it. The
+  // trees of neighbouring slabs differ only by the edges that start or
+  // end between them, so they are versions of one persistent treap built
+  // by a left-to-right sweep, which copies O(log n) nodes per edge: the
+  // memory is O(n log n) expected however many edges each slab holds.
+  // Self-intersecting polygons, found by the sweep checking every pair of
+  // edges that become neighbours, fall back to Polygon::ContainsPoint.
+  class PreparedPolygon final : public IShape {
+   public:
+    PreparedPolygon() = default;
+
+    explicit PreparedPolygon(const Polygon& polygon);
+
+    PreparedPolygon& operator=(const PreparedPolygon& other) = default;
+
+    IShape& Move(const Vector& vector) override;
+
+    bool ContainsPoint(const Point& point) const override;
+
+    bool CrossesSegment(const Segment& seg) const override;
+
+    std::string ToString() const override;
+
+    IShape* Clone() const override;
+
+    std::optional<Box> BoundingBox() const override;
+
+    const Polygon& GetPolygon() const;
+
+   private:
+    enum class Mode { kConvex, kSlabs, kFallback };
+
+    // Non-vertical edge directed left to right.
+    struct Edge {
+      Vector l;
+      Vector r;
+    };
+
+    // Vertices and vertical edges on the line x: the points from low to
+    // high.
+    struct Bound {
+      int x;
+      int low;
+      int high;
+    };
+
+    // Node of the treap over the edges crossing a slab, ordered from
+    // bottom to top. Node 0 is the empty tree; nodes are never changed
+    // once added, only copied.
+    struct Node {
+      uint32_t edge;
+      uint32_t left;
+      uint32_t right;
+      uint32_t size;
+    };
+
+    // Sign of y(first) - y(second) at x = x2 / 2.
+    static int CompareAt(const Edge& first, const Edge& second, long long x2);
+
+    // Heap order of the treap, a hash of the edge so that builds repeat.
+    static uint32_t Priority(uint32_t edge);
+
+    // Whether edges_[first] lies below edges_[second] at x = x2 / 2, ties
+    // broken by position.
+    bool Less(uint32_t first, uint32_t second, long long x2) const;
+
+    // Whether the edges of two nodes cross at a point inside both.
+    bool Crosses(uint32_t first, uint32_t second) const;
+
+    uint32_t Add(Node node);
+
+    // Splits the tree into the edges below edge and the rest.
+    void Split(uint32_t root, uint32_t edge, long long x2, uint32_t& less,
+               uint32_t& rest);
+
+    // Joins two trees, every edge of first below every edge of second.
+    uint32_t Merge(uint32_t first, uint32_t second);
+
+    uint32_t EraseFirst(uint32_t root);
+
+    uint32_t First(uint32_t root) const;
+
+    uint32_t Last(uint32_t root) const;
+
+    bool BuildConvex();
+
+    bool BuildSlabs();
+
+    bool ContainsConvex(const Vector& point) const;
+
+    bool ContainsSlabs(const Vector& point) const;
+
+    Polygon polygon_;
+    // Sum of all moves; queries are shifted back instead of rebuilding.
+    Vector offset_;
+    Mode mode_ = Mode::kFallback;
+    // Counterclockwise, without repeated or collinear vertices.
+    std::vector<Vector> convex_;
+    std::vector<int> slab_x_;
+    std::vector<Edge> edges_;
+    std::vector<Node> nodes_;
+    // Slab i lies between slab_x_[i] and slab_x_[i + 1]; nodes_[roots_[i]]
+    // is the root of the tree of its edges.
+    std::vector<uint32_t> roots_;
+    // Sorted by x and low, overlapping ones merged.
+    std::vector<Bound> bounds_;
+  };
+
+  // Answers which of many shapes contain a point or cross a segment while
+  // testing only the shapes whose bounding boxes the query touches. The
+  // bounded shapes go into an R-tree packed bottom-up by sort-tile-
+  // recursive (STR) order, kNodeSize boxes per node; Line and Ray have no
+  // box and are tested on every query.
+  //
+  // The index points to the shapes without owning them; they must outlive
+  // it and must not be moved while indexed.
+  class ShapeIndex {
+   public:
+    ShapeIndex() = default;
+
+    explicit ShapeIndex(const std::vector<IShape*>& shapes);
+
+    // Positions in shapes of those that contain the point, ascending.
+    std::vector<size_t> ShapesContaining(const Point& point) const;
+
+    // Positions in shapes of those that cross the segment, ascending.
+    std::vector<size_t> ShapesCrossing(const Segment& seg) const;
+
+    size_t Size() const;
+
+   private:
+    static const size_t kNodeSize = 8;
+
+    struct Entry {
+      Box box;
+      // Position in shapes_ for leaves, in nodes_ for nodes.
+      size_t index;
+    };
+
+    // Children are items_[begin, end) for a leaf, nodes_[begin, end)
+    // otherwise.
+    struct Node {
+      Box box;
+      size_t begin;
+      size_t end;
+      bool leaf;
+    };
+
+    // Orders entries so that runs of kNodeSize are close together: sorted
+    // by the x of their centers into vertical slices of about
+    // sqrt(nodes) runs each, every slice sorted by y.
+    static void SortTiles(std::vector<Entry>& entries);
+
+    // Calls visit(index) for every shape whose box passes box_test, with
+    // box_test also deciding which nodes to descend into.
+    template <typename BoxTest, typename Visit>
+    void Search(BoxTest box_test, Visit visit) const;
+
+    std::vector<IShape*> shapes_;
+    std::vector<size_t> unbounded_;
+    std::vector<Entry> items_;
+    // Level by level from the leaves up; the root is the last node.
+    std::vector<Node> nodes_;
+  };
+
+  // Any shape but PreparedPolygon held by value. The predicates dispatch
+  // with std::visit over the concrete classes, which are final, so every
+  // branch is a direct call the compiler can inline, and copying a Shape
+  // needs neither Clone() nor a heap allocation per shape.
+  class Shape {
+   public:
+    using Variant = std::variant<Point, Segment, Line, Ray, Circle, Polygon>;
+
+    Shape() = default;
+
+    template <typename T>
+      requires std::is_constructible_v<Variant, T&&>
+    Shape(T&& shape) : shape_(std::forward<T>(shape)) {}
+
+    Shape& Move(const Vector& vector);
+
+    bool ContainsPoint(const Point& point) const;
+
+    bool CrossesSegment(const Segment& seg) const;
+
+    std::string ToString() const;
+
+    std::optional<Box> BoundingBox() const;
+
+    const Variant& GetVariant() const;
+
+   private:
+    Variant shape_;
+  };
+
+  // Shapes of one type stored by value next to each other, for bulk
+  // queries sorted by type: the loops call the predicates of T directly.
+  // The vertices of a ShapeVector<Polygon> come from a pool owned by the
+  // container instead of one heap block per polygon.
+  template <typename T>
+  class ShapeVector {
+   public:
+    ShapeVector() = default;
+
+    void Push(const T& shape);
+
+    size_t Size() const;
+
+    const T& operator[](size_t index) const;
+
+    // Moves every shape.
+    ShapeVector& Move(const Vector& vector);
+
+    // Positions of the shapes that contain the point, ascending.
+    std::vector<size_t> ShapesContaining(const Point& point) const;
+
+    // Positions of the shapes that cross the segment, ascending.
+    std::vector<size_t> ShapesCrossing(const Segment& seg) const;
+
+   private:
+    // Declared before shapes_, which may use it, so that it outlives them.
+    std::unique_ptr<std::pmr::unsynchronized_pool_resource> pool_;
+    std::vector<T> shapes_;
+  };
+
+/////////////////////////////////////IShape/////////////////////////////////////
+  void IShape::ContainsPoints(const PointBuffer& points,
+                              std::span<uint8_t> out) const {
+    for (size_t i = 0; i < points.Size(); i++) {
+      out[i] = ContainsPoint(Point(points.x[i], points.y[i]));
+    }
+  }
+
+  void IShape::CrossesSegments(const SegmentBuffer& segments,
+                               std::span<uint8_t> out) const {
+    for (size_t i = 0; i < segments.Size(); i++) {
+      out[i] = CrossesSegment(Segment(Point(segments.x1[i], segments.y1[i]),
+                                      Point(segments.x2[i], segments.y2[i])));
+    }
+  }
+
+//////////////////////////////////PointBuffer///////////////////////////////////
+  PointBuffer::PointBuffer(std::span<const Vector> points) {
+    x.reserve(points.size());
+    y.reserve(points.size());
+    for (const auto& point : points) {
+      Push(point);
+    }
+  }
+
+  void PointBuffer::Push(const Vector& point) {
+    x.push_back(point.x);
+    y.push_back(point.y);
+  }
+
+  size_t PointBuffer::Size() const { return x.size(); }
+
+  SegmentBuffer::SegmentBuffer(std::span<const Segment> segments) {
+    x1.reserve(segments.size());
+    y1.reserve(segments.size());
+    x2.reserve(segments.size());
+    y2.reserve(segments.size());
+    for (const auto& segment : segments) {
+      Push(segment);
+    }
+  }
+
+  void SegmentBuffer::Push(const Segment& segment) {
+    x1.push_back(segment.GetL().coordinate.x);
+    y1.push_back(segment.GetL().coordinate.y);
+    x2.push_back(segment.GetR().coordinate.x);
+    y2.push_back(segment.GetR().coordinate.y);
+  }
+
+  size_t SegmentBuffer::Size() const { return x1.size(); }
+
+//////////////////////////////////////Box///////////////////////////////////////
+  void Box::Extend(const Vector& point) {
+    min_x = std::min(min_x, point.x);
+    min_y = std::min(min_y, point.y);
+    max_x = std::max(max_x, point.x);
+    max_y = std::max(max_y, point.y);
+  }
+
+  void Box::Extend(const Box& box) {
+    min_x = std::min(min_x, box.min_x);
+    min_y = std::min(min_y, box.min_y);
+    max_x = std::max(max_x, box.max_x);
+    max_y = std::max(max_y, box.max_y);
+  }
+
+  bool Box::Empty() const { return min_x > max_x || min_y > max_y; }
+
+  bool Box::ContainsPoint(const Vector& point) const {
+    return min_x <= point.x && point.x <= max_x && min_y <= point.y &&
+           point.y <= max_y;
+  }
+
+  bool Box::Intersects(const Box& box) const {
+    return min_x <= box.max_x && box.min_x <= max_x && min_y <= box.max_y &&
+           box.min_y <= max_y;
+  }
+
+  bool Box::CrossesSegment(const Vector& a, const Vector& b) const {
+    Box seg_box;
+    seg_box.Extend(a);
+    seg_box.Extend(b);
+    if (!Intersects(seg_box)) {
+      return false;
+    }
+    int sides[2] = {0, 0};
+    for (const Vector& corner : {Vector(min_x, min_y), Vector(min_x, max_y),
+                                 Vector(max_x, min_y), Vector(max_x, max_y)}) {
+      long long cross = Cross(a, b, corner);
+      if (cross == 0) {
+        return true;
+      }
+      ++sides[cross > 0];
+    }
+    return sides[0] != 0 && sides[1] != 0;
+  }
+
+/////////////////////////////////////Batch//////////////////////////////////////
+  // AVX2 kernels of the batch queries. They take four points (segments)
+  // per step with every coordinate in a 64-bit lane, so the products are
+  // as exact as the long long ones of the scalar predicates, and return
+  // how many elements they handled; the shapes finish the rest with the
+  // scalar predicates, which are also all there is without AVX2. SSE2 has
+  // no signed 32 x 32 -> 64 bit multiply and no 64-bit comparison, so
+  // there is no SSE version.
+  namespace batch {
+
+#if defined(__x86_64__)
+
+  bool HasAvx2() {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+  }
+
+  // A function-local static, resolved on first use, so that a batch query
+  // run from another translation unit's static initializer still sees the
+  // CPU's answer.
+  bool UseAvx2() {
+    static const bool kAvx2 = HasAvx2();
+    return kAvx2;
+  }
+
+  // Four ints sign-extended to 64-bit lanes.
+  __attribute__((target("avx2"))) __m256i Load(const int* data) {
+    return _mm256_cvtepi32_epi64(_mm_loadu_si128((const __m128i*)data));
+  }
+
+  __attribute__((target("avx2"))) __m256i Set(long long value) {
+    return _mm256_set1_epi64x(value);
+  }
+
+  // Products of the low 32 bits of the lanes, as int * int in the scalar
+  // code.
+  __attribute__((target("avx2"))) __m256i Mul(__m256i l, __m256i r) {
+    return _mm256_mul_epi32(l, r);
+  }
+
+  // Writes the lanes of mask (all ones or zero) to out[0, 4) as 1 or 0:
+  // the multiplication moves bit k of the lane mask to bit 8 k.
+  __attribute__((target("avx2"))) void Store(uint8_t* out, __m256i mask) {
+    uint32_t bits = _mm256_movemask_pd(_mm256_castsi256_pd(mask));
+    uint32_t bytes = (bits * 0x204081) & 0x01010101;
+    memcpy(out, &bytes, sizeof(bytes));
+  }
+
+  __attribute__((target("avx2"))) __m256i Cross(__m256i ax, __m256i ay,
+                                                __m256i bx, __m256i by,
+                                                __m256i px, __m256i py) {
+    return _mm256_sub_epi64(
+            Mul(_mm256_sub_epi64(bx, ax), _mm256_sub_epi64(py, ay)),
+            Mul(_mm256_sub_epi64(by, ay), _mm256_sub_epi64(px, ax)));
+  }
+
+  // Lanes where p is not between a and b.
+  __attribute__((target("avx2"))) __m256i Outside(__m256i a, __m256i b,
+                                                  __m256i p) {
+    return _mm256_or_si256(
+            _mm256_and_si256(_mm256_cmpgt_epi64(a, p),
+                             _mm256_cmpgt_epi64(b, p)),
+            _mm256_and_si256(_mm256_cmpgt_epi64(p, a),
+                             _mm256_cmpgt_epi64(p, b)));
+  }
+
+  // Lanes where p lies on the segment a b, given cross = Cross(a, b, p).
+  __attribute__((target("avx2"))) __m256i OnSegment(__m256i ax, __m256i ay,
+                                                    __m256i bx, __m256i by,
+                                                    __m256i px, __m256i py,
+                                                    __m256i cross) {
+    return _mm256_andnot_si256(
+            _mm256_or_si256(Outside(ax, bx, px), Outside(ay, by, py)),
+            _mm256_cmpeq_epi64(cross, _mm256_setzero_si256()));
+  }
+
+  // Lanes where l and r are both nonzero and of opposite signs.
+  __attribute__((target("avx2"))) __m256i Opposite(__m256i l, __m256i r) {
+    __m256i zero = _mm256_setzero_si256();
+    return _mm256_or_si256(
+            _mm256_and_si256(_mm256_cmpgt_epi64(l, zero),
+                             _mm256_cmpgt_epi64(zero, r)),
+            _mm256_and_si256(_mm256_cmpgt_epi64(zero, l),
+                             _mm256_cmpgt_epi64(r, zero)));
+  }
+
+  // Segment::CrossesSegment of the segments a b and c d.
+  __attribute__((target("avx2"))) __m256i SegmentsCross(
+          __m256i ax, __m256i ay, __m256i bx, __m256i by, __m256i cx,
+          __m256i cy, __m256i dx, __m256i dy) {
+    __m256i abc = Cross(ax, ay, bx, by, cx, cy);
+    __m256i abd = Cross(ax, ay, bx, by, dx, dy);
+    __m256i cda = Cross(cx, cy, dx, dy, ax, ay);
+    __m256i cdb = Cross(cx, cy, dx, dy, bx, by);
+    __m256i touch = _mm256_or_si256(
+            _mm256_or_si256(OnSegment(ax, ay, bx, by, cx, cy, abc),
+                            OnSegment(ax, ay, bx, by, dx, dy, abd)),
+            _mm256_or_si256(OnSegment(cx, cy, dx, dy, ax, ay, cda),
+                            OnSegment(cx, cy, dx, dy, bx, by, cdb)));
+    return _mm256_or_si256(
+            touch, _mm256_and_si256(Opposite(abc, abd), Opposite(cda, cdb)));
+  }
+
+  // Ray::ContainsPoint: p is on the line of the ray and not behind its
+  // origin o.
+  __attribute__((target("avx2"))) __m256i RayHas(__m256i ox, __m256i oy,
+                                                 __m256i vx, __m256i vy,
+                                                 __m256i px, __m256i py) {
+    __m256i dx = _mm256_sub_epi64(px, ox);
+    __m256i dy = _mm256_sub_epi64(py, oy);
+    __m256i cross = _mm256_sub_epi64(Mul(vx, dy), Mul(vy, dx));
+    __m256i dot = _mm256_add_epi64(Mul(vx, dx), Mul(vy, dy));
+    return _mm256_andnot_si256(
+            _mm256_cmpgt_epi64(_mm256_setzero_si256(), dot),
+            _mm256_cmpeq_epi64(cross, _mm256_setzero_si256()));
+  }
+
+  // Line::ContainsPoint: a x + b y + c == 0.
+  __attribute__((target("avx2"))) __m256i LineHas(__m256i a, __m256i b,
+                                                  __m256i c, __m256i px,
+                                                  __m256i py) {
+    return _mm256_cmpeq_epi64(
+            _mm256_add_epi64(_mm256_add_epi64(Mul(a, px), Mul(b, py)), c),
+            _mm256_setzero_si256());
+  }
+
+  __attribute__((target("avx2"))) size_t CircleContains(
+          const Vector& center, int radius, const PointBuffer& points,
+          uint8_t* out) {
+    __m256i cx = Set(center.x);
+    __m256i cy = Set(center.y);
+    // d <= r * r as r * r + 1 > d.
+    __m256i bound = Set((long long)radius * radius + 1);
+    size_t i = 0;
+    for (; i + 4 <= points.Size(); i += 4) {
+      __m256i dx = _mm256_sub_epi64(Load(&points.x[i]), cx);
+      __m256i dy = _mm256_sub_epi64(Load(&points.y[i]), cy);
+      __m256i dist = _mm256_add_epi64(Mul(dx, dx), Mul(dy, dy));
+      Store(out + i, _mm256_cmpgt_epi64(bound, dist));
+    }
+    return i;
+  }
+
+  __attribute__((target("avx2"))) size_t LineContains(
+          int a, int b, int c, const PointBuffer& points, uint8_t* out) {
+    size_t i = 0;
+    for (; i + 4 <= points.Size(); i += 4) {
+      Store(out + i, LineHas(Set(a), Set(b), Set(c), Load(&points.x[i]),
+                             Load(&points.y[i])));
+    }
+    return i;
+  }
+
+  __attribute__((target("avx2"))) size_t RayContains(
+          const Vector& origin, const Vector& vector,
+          const PointBuffer& points, uint8_t* out) {
+    size_t i = 0;
+    for (; i + 4 <= points.Size(); i += 4) {
+      Store(out + i, RayHas(Set(origin.x), Set(origin.y), Set(vector.x),
+                            Set(vector.y), Load(&points.x[i]),
+                            Load(&points.y[i])));
+    }
+    return i;
+  }
+
+  __attribute__((target("avx2"))) size_t SegmentContains(
+          const Vector& l, const Vector& r, const PointBuffer& points,
+          uint8_t* out) {
+    __m256i lx = Set(l.x);
+    __m256i ly = Set(l.y);
+    __m256i rx = Set(r.x);
+    __m256i ry = Set(r.y);
+    size_t i = 0;
+    for (; i + 4 <= points.Size(); i += 4) {
+      __m256i px = Load(&points.x[i]);
+      __m256i py = Load(&points.y[i]);
+      Store(out + i, OnSegment(lx, ly, rx, ry, px, py,
+                               Cross(lx, ly, rx, ry, px, py)));
+    }
+    return i;
+  }
+
+  // The crossing-number test of Polygon::ContainsPoint with the loops
+  // swapped: every edge is applied to four points at once.
+  __attribute__((target("avx2"))) size_t PolygonContains(
+          std::span<const Point> vertices, const PointBuffer& points,
+          uint8_t* out) {
+    size_t n = vertices.size();
+    size_t i = 0;
+    for (; i + 4 <= points.Size(); i += 4) {
+      __m256i px = Load(&points.x[i]);
+      __m256i py = Load(&points.y[i]);
+      __m256i inside = _mm256_setzero_si256();
+      __m256i boundary = _mm256_setzero_si256();
+      for (size_t j = 0; j < n; j++) {
+        const Vector& a = vertices[j == 0 ? n - 1 : j - 1].coordinate;
+        const Vector& b = vertices[j].coordinate;
+        __m256i ax = Set(a.x);
+        __m256i ay = Set(a.y);
+        __m256i bx = Set(b.x);
+        __m256i by = Set(b.y);
+        __m256i cross = Cross(ax, ay, bx, by, px, py);
+        boundary = _mm256_or_si256(
+                boundary, OnSegment(ax, ay, bx, by, px, py, cross));
+        __m256i straddle = _mm256_xor_si256(_mm256_cmpgt_epi64(ay, py),
+                                            _mm256_cmpgt_epi64(by, py));
+        __m256i left = _mm256_cmpgt_epi64(cross, _mm256_setzero_si256());
+        inside = _mm256_xor_si256(
+                inside, (b.y > a.y ? _mm256_and_si256(straddle, left)
+                                   : _mm256_andnot_si256(left, straddle)));
+      }
+      Store(out + i, _mm256_or_si256(inside, boundary));
+    }
+    return i;
+  }
+
+  __attribute__((target("avx2"))) size_t SegmentCrosses(
+          const Vector& l, const Vector& r, const SegmentBuffer& segments,
+          uint8_t* out) {
+    size_t i = 0;
+    for (; i + 4 <= segments.Size(); i += 4) {
+      Store(out + i, SegmentsCross(Set(l.x), Set(l.y), Set(r.x), Set(r.y),
+                                   Load(&segments.x1[i]),
+                                   Load(&segments.y1[i]),
+                                   Load(&segments.x2[i]),
+                                   Load(&segments.y2[i])));
+    }
+    return i;
+  }
+
+  __attribute__((target("avx2"))) size_t LineCrosses(
+          int a, int b, int c, const Vector& l, const Vector& r,
+          const SegmentBuffer& segments, uint8_t* out) {
+    __m256i lx = Set(l.x);
+    __m256i ly = Set(l.y);
+    __m256i rx = Set(r.x);
+    __m256i ry = Set(r.y);
+    size_t i = 0;
+    for (; i + 4 <= segments.Size(); i += 4) {
+      __m256i x1 = Load(&segments.x1[i]);
+      __m256i y1 = Load(&segments.y1[i]);
+      __m256i x2 = Load(&segments.x2[i]);
+      __m256i y2 = Load(&segments.y2[i]);
+      __m256i ends = _mm256_or_si256(LineHas(Set(a), Set(b), Set(c), x1, y1),
+                                     LineHas(Set(a), Set(b), Set(c), x2, y2));
+      Store(out + i, _mm256_or_si256(
+                             ends, Opposite(Cross(lx, ly, rx, ry, x1, y1),
+                                            Cross(lx, ly, rx, ry, x2, y2))));
+    }
+    return i;
+  }
+
+  __attribute__((target("avx2"))) size_t RayCrosses(
+          const Vector& origin, const Vector& vector,
+          const SegmentBuffer& segments, uint8_t* out) {
+    __m256i ox = Set(origin.x);
+    __m256i oy = Set(origin.y);
+    __m256i vx = Set(vector.x);
+    __m256i vy = Set(vector.y);
+    __m256i zero = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 4 <= segments.Size(); i += 4) {
+      __m256i x1 = Load(&segments.x1[i]);
+      __m256i y1 = Load(&segments.y1[i]);
+      __m256i x2 = Load(&segments.x2[i]);
+      __m256i y2 = Load(&segments.y2[i]);
+      __m256i dx1 = _mm256_sub_epi64(x1, ox);
+      __m256i dy1 = _mm256_sub_epi64(y1, oy);
+      __m256i dx2 = _mm256_sub_epi64(x2, ox);
+      __m256i dy2 = _mm256_sub_epi64(y2, oy);
+      __m256i behind = _mm256_or_si256(
+              _mm256_cmpgt_epi64(
+                      zero, _mm256_add_epi64(Mul(vx, dx1), Mul(vy, dy1))),
+              _mm256_cmpgt_epi64(
+                      zero, _mm256_add_epi64(Mul(vx, dx2), Mul(vy, dy2))));
+      __m256i sides =
+              Opposite(_mm256_sub_epi64(Mul(vx, dy1), Mul(vy, dx1)),
+                       _mm256_sub_epi64(Mul(vx, dy2), Mul(vy, dx2)));
+      __m256i ends = _mm256_or_si256(RayHas(ox, oy, vx, vy, x1, y1),
+                                     RayHas(ox, oy, vx, vy, x2, y2));
+      Store(out + i,
+            _mm256_or_si256(ends, _mm256_andnot_si256(behind, sides)));
+    }
+    return i;
+  }
+
+  // Stops walking the edges once all four segments cross one.
+  __attribute__((target("avx2"))) size_t PolygonCrosses(
+          std::span<const Point> vertices, const SegmentBuffer& segments,
+          uint8_t* out) {
+    size_t n = vertices.size();
+    size_t i = 0;
+    for (; i + 4 <= segments.Size(); i += 4) {
+      __m256i x1 = Load(&segments.x1[i]);
+      __m256i y1 = Load(&segments.y1[i]);
+      __m256i x2 = Load(&segments.x2[i]);
+      __m256i y2 = Load(&segments.y2[i]);
+      __m256i crosses = _mm256_setzero_si256();
+      for (size_t j = 0; j < n && _mm256_movemask_pd(_mm256_castsi256_pd(
+                                          crosses)) != 0xF; j++) {
+        const Vector& a = vertices[j == 0 ? n - 1 : j - 1].coordinate;
+        const Vector& b = vertices[j].coordinate;
+        crosses = _mm256_or_si256(
+                crosses, SegmentsCross(x1, y1, x2, y2, Set(a.x), Set(a.y),
+                                       Set(b.x), Set(b.y)));
+      }
+      Store(out + i, crosses);
+    }
+    return i;
+  }
+
+#endif
+
+  }  // namespace batch
+
 ////////////////////////////////////Point///////////////////////////////////////
   Point::Point(int x, int y) : coordinate(x, y) {}
 
@@ -281,10 +1100,18 @@ namespace Geometry {
     return coordinate == in_point.coordinate;
   }
 
+  void AppendPoint(std::string& output, const Vector& coordinate) {
+    output += "Point(";
+    AppendNumber(output, coordinate.x);
+    output += ", ";
+    AppendNumber(output, coordinate.y);
+    output += ')';
+  }
+
   std::string Point::ToString() const {
     std::string output;
-    output = "Point(" + std::to_string(coordinate.x) + ", " +
-             std::to_string(coordinate.y) + ")";
+    output.reserve(32);
+    AppendPoint(output, coordinate);
     return output;
   }
 
@@ -297,6 +1124,12 @@ namespace Geometry {
     return clone;
   }
 
+  std::optional<Box> Point::BoundingBox() const {
+    Box box;
+    box.Extend(coordinate);
+    return box;
+  }
+
   Vector operator-(const Point& l, const Point& r) {
     Vector vector = l.coordinate - r.coordinate;
     return vector;
@@ -332,15 +1165,19 @@ namespace Geometry {
   bool Segment::CrossesSegment(const Segment& seg) const {
     return seg.ContainsPoint(l_) || seg.ContainsPoint(r_) ||
            ContainsPoint(seg.l_) || ContainsPoint(seg.r_) ||
-           (Sign(((l_ - r_) ^ (l_ - seg.r_)) * ((l_ - r_) ^ (l_ - seg.l_))) ==
+           (Sign((l_ - r_) ^ (l_ - seg.r_)) * Sign((l_ - r_) ^ (l_ - seg.l_)) ==
             -1 &&
-            Sign(((seg.l_ - seg.r_) ^ (seg.l_ - r_)) *
-                 ((seg.l_ - seg.r_) ^ (seg.l_ - l_))) == -1);
+            Sign((seg.l_ - seg.r_) ^ (seg.l_ - r_)) *
+            Sign((seg.l_ - seg.r_) ^ (seg.l_ - l_)) == -1);
   }
 
   std::string Segment::ToString() const {
-    std::string output;
-    output = "Segment(" + l_.ToString() + ", " + r_.ToString() + ")";
+    std::string output = "Segment(";
+    output.reserve(80);
+    AppendPoint(output, l_.coordinate);
+    output += ", ";
+    AppendPoint(output, r_.coordinate);
+    output += ')';
     return output;
   }
 
@@ -349,10 +1186,47 @@ namespace Geometry {
     return clone;
   }
 
+  std::optional<Box> Segment::BoundingBox() const {
+    Box box;
+    box.Extend(l_.coordinate);
+    box.Extend(r_.coordinate);
+    return box;
+  }
+
   Point Segment::GetL() const { return l_; }
 
   Point Segment::GetR() const { return r_; }
 
+  void Segment::ContainsPoints(const PointBuffer& points,
+                               std::span<uint8_t> out) const {
+    size_t i = 0;
+#if defined(__x86_64__)
+    if (batch::UseAvx2()) {
+      i = batch::SegmentContains(l_.coordinate, r_.coordinate, points,
+                                 out.data());
+    }
+#endif
+    for (; i < points.Size(); i++) {
+      out[i] = Segment::ContainsPoint(Point(points.x[i], points.y[i]));
+    }
+  }
+
+  void Segment::CrossesSegments(const SegmentBuffer& segments,
+                                std::span<uint8_t> out) const {
+    size_t i = 0;
+#if defined(__x86_64__)
+    if (batch::UseAvx2()) {
+      i = batch::SegmentCrosses(l_.coordinate, r_.coordinate, segments,
+                                out.data());
+    }
+#endif
+    for (; i < segments.Size(); i++) {
+      out[i] = Segment::CrossesSegment(
+              Segment(Point(segments.x1[i], segments.y1[i]),
+                      Point(segments.x2[i], segments.y2[i])));
+    }
+  }
+
 //////////////////////////////////////Line//////////////////////////////////////
   Line::Line(const Point& l, const Point& r) : l_(l), r_(r) {
     a_ = r.coordinate.y - l.coordinate.y;
@@ -369,19 +1243,26 @@ namespace Geometry {
   }
 
   bool Line::ContainsPoint(const Point& point) const {
-    return a_ * point.coordinate.x + b_ * point.coordinate.y + c_ == 0;
+    return (long long)a_ * point.coordinate.x +
+           (long long)b_ * point.coordinate.y + c_ ==
+           0;
   }
 
   bool Line::CrossesSegment(const Segment& seg) const {
     return ContainsPoint(seg.GetL()) || ContainsPoint(seg.GetR()) ||
-           (Sign((l_ - r_) ^ (l_ - seg.GetL())) *
-            ((l_ - r_) ^ (l_ - seg.GetR()))) == -1;
+           Sign((l_ - r_) ^ (l_ - seg.GetL())) *
+           Sign((l_ - r_) ^ (l_ - seg.GetR())) == -1;
   }
 
   std::string Line::ToString() const {
-    std::string output;
-    output = "Line(" + std::to_string(a_) + ", " + std::to_string(b_) + ", " +
-             std::to_string(c_) + ")";
+    std::string output = "Line(";
+    output.reserve(48);
+    AppendNumber(output, a_);
+    output += ", ";
+    AppendNumber(output, b_);
+    output += ", ";
+    AppendNumber(output, c_);
+    output += ')';
     return output;
   }
 
@@ -390,6 +1271,37 @@ namespace Geometry {
     return clone;
   }
 
+  std::optional<Box> Line::BoundingBox() const { return std::nullopt; }
+
+  void Line::ContainsPoints(const PointBuffer& points,
+                            std::span<uint8_t> out) const {
+    size_t i = 0;
+#if defined(__x86_64__)
+    if (batch::UseAvx2()) {
+      i = batch::LineContains(a_, b_, c_, points, out.data());
+    }
+#endif
+    for (; i < points.Size(); i++) {
+      out[i] = Line::ContainsPoint(Point(points.x[i], points.y[i]));
+    }
+  }
+
+  void Line::CrossesSegments(const SegmentBuffer& segments,
+                             std::span<uint8_t> out) const {
+    size_t i = 0;
+#if defined(__x86_64__)
+    if (batch::UseAvx2()) {
+      i = batch::LineCrosses(a_, b_, c_, l_.coordinate, r_.coordinate,
+                             segments, out.data());
+    }
+#endif
+    for (; i < segments.Size(); i++) {
+      out[i] = Line::CrossesSegment(
+              Segment(Point(segments.x1[i], segments.y1[i]),
+                      Point(segments.x2[i], segments.y2[i])));
+    }
+  }
+
 ////////////////////////////////////Ray/////////////////////////////////////////
   Ray::Ray(const Point& point, const Point& point1) : point_(point) {
     vector_ = point1 - point;
@@ -401,8 +1313,8 @@ namespace Geometry {
   }
 
   bool Ray::ContainsPoint(const Point& point) const {
-    return vector_.x * (point.coordinate.y - point_.coordinate.y) ==
-           vector_.y * (point.coordinate.x - point_.coordinate.x) &&
+    return (long long)vector_.x * (point.coordinate.y - point_.coordinate.y) ==
+           (long long)vector_.y * (point.coordinate.x - point_.coordinate.x) &&
            Sign(vector_.x) * Sign(point.coordinate.x - point_.coordinate.x) >=
            0 &&
            Sign(vector_.y) * Sign(point.coordinate.y - point_.coordinate.y) >= 0;
@@ -410,16 +1322,21 @@ namespace Geometry {
 
   bool Ray::CrossesSegment(const Segment& seg) const {
     return ContainsPoint(seg.GetL()) || ContainsPoint(seg.GetR()) ||
-           (Sign((vector_ ^ (seg.GetL() - point_)) *
-                 (vector_ ^ (seg.GetR() - point_))) == -1 &&
+           (Sign(vector_ ^ (seg.GetL() - point_)) *
+            Sign(vector_ ^ (seg.GetR() - point_)) == -1 &&
             vector_ * (seg.GetL() - point_) >= 0 &&
             vector_ * (seg.GetR() - point_) >= 0);
   }
 
   std::string Ray::ToString() const {
-    std::string output;
-    output = "Ray(" + point_.ToString() + ", Vector(" +
-             std::to_string(vector_.x) + ", " + std::to_string(vector_.y) + "))";
+    std::string output = "Ray(";
+    output.reserve(80);
+    AppendPoint(output, point_.coordinate);
+    output += ", Vector(";
+    AppendNumber(output, vector_.x);
+    output += ", ";
+    AppendNumber(output, vector_.y);
+    output += "))";
     return output;
   }
 
@@ -430,8 +1347,47 @@ namespace Geometry {
     return clone;
   }
 
+  std::optional<Box> Ray::BoundingBox() const { return std::nullopt; }
+
+  void Ray::ContainsPoints(const PointBuffer& points,
+                           std::span<uint8_t> out) const {
+    size_t i = 0;
+#if defined(__x86_64__)
+    if (batch::UseAvx2()) {
+      i = batch::RayContains(point_.coordinate, vector_, points, out.data());
+    }
+#endif
+    for (; i < points.Size(); i++) {
+      out[i] = Ray::ContainsPoint(Point(points.x[i], points.y[i]));
+    }
+  }
+
+  void Ray::CrossesSegments(const SegmentBuffer& segments,
+                            std::span<uint8_t> out) const {
+    size_t i = 0;
+#if defined(__x86_64__)
+    if (batch::UseAvx2()) {
+      i = batch::RayCrosses(point_.coordinate, vector_, segments, out.data());
+    }
+#endif
+    for (; i < segments.Size(); i++) {
+      out[i] = Ray::CrossesSegment(
+              Segment(Point(segments.x1[i], segments.y1[i]),
+                      Point(segments.x2[i], segments.y2[i])));
+    }
+  }
+
 /////////////////////////////////////Polygon////////////////////////////////////
-  Polygon::Polygon(std::vector<Point> points) : points_(std::move(points)) {}
+  Polygon::Polygon(const std::vector<Point>& points,
+                   std::pmr::memory_resource* resource)
+          : points_(points.begin(), points.end(),
+                    (resource == nullptr ? std::pmr::get_default_resource()
+                                         : resource)) {}
+
+  Polygon::Polygon(const Polygon& other, std::pmr::memory_resource* resource)
+          : points_(other.points_,
+                    (resource == nullptr ? std::pmr::get_default_resource()
+                                         : resource)) {}
 
   IShape& Polygon::Move(const Vector& vector) {
     for (auto& point : points_) {
@@ -440,36 +1396,24 @@ namespace Geometry {
     return *this;
   }
 
+  // Counts the edges crossed by the horizontal ray to the right of the
+  // point. An edge is counted when exactly one of its ends lies strictly
+  // above the ray, so rays through vertices need no retry.
   bool Polygon::ContainsPoint(const Point& point) const {
-    for (size_t i = 1; i < points_.size(); i++) {
-      Segment seg_i(points_[i - 1], points_[i]);
-      if (seg_i.ContainsPoint(point)) {
+    const Vector& p = point.coordinate;
+    bool inside = false;
+    for (size_t i = 0; i < points_.size(); i++) {
+      const Vector& a =
+          points_[i == 0 ? points_.size() - 1 : i - 1].coordinate;
+      const Vector& b = points_[i].coordinate;
+      if (OnSegment(a, b, p)) {
         return true;
       }
-    }
-    Segment seg_0(points_[points_.size() - 1], points_[0]);
-    if (seg_0.ContainsPoint(point)) {
-      return true;
-    }
-    while (true) {
-      Point point1(point);
-      point1.Move({rand() % 100 + 1, rand() % 100 + 1});
-      Ray ray(point, point1);
-      bool cnt = false;
-      bool ok = true;
-      for (const auto& point_i : points_) {
-        ok &= 1 - static_cast<int>(ray.ContainsPoint(point_i));
-      }
-      if (ok) {
-        for (size_t i = 1; i < points_.size(); i++) {
-          cnt ^=
-                  static_cast<int>(ray.CrossesSegment({points_[i - 1], points_[i]}));
-        }
-        cnt ^=
-                static_cast<int>(ray.CrossesSegment({*points_.rbegin(), points_[0]}));
-        return cnt;
+      if ((a.y > p.y) != (b.y > p.y) && (Cross(a, b, p) > 0) == (b.y > a.y)) {
+        inside = !inside;
       }
     }
+    return inside;
   }
 
   bool Polygon::CrossesSegment(const Segment& seg) const {
@@ -485,8 +1429,9 @@ namespace Geometry {
 
   std::string Polygon::ToString() const {
     std::string output = "Polygon(";
+    output.reserve(10 + 34 * points_.size());
     for (size_t i = 0; i < points_.size(); i++) {
-      output += points_[i].ToString();
+      AppendPoint(output, points_[i].coordinate);
       if (i != points_.size() - 1) {
         output += ", ";
       }
@@ -496,10 +1441,48 @@ namespace Geometry {
   }
 
   IShape* Polygon::Clone() const {
-    auto* clone = new Polygon(points_);
+    auto* clone = new Polygon(*this);
     return clone;
   }
 
+  std::optional<Box> Polygon::BoundingBox() const {
+    Box box;
+    for (const auto& point : points_) {
+      box.Extend(point.coordinate);
+    }
+    return box;
+  }
+
+  std::span<const Point> Polygon::GetPoints() const { return points_; }
+
+  void Polygon::ContainsPoints(const PointBuffer& points,
+                               std::span<uint8_t> out) const {
+    size_t i = 0;
+#if defined(__x86_64__)
+    if (batch::UseAvx2()) {
+      i = batch::PolygonContains(points_, points, out.data());
+    }
+#endif
+    for (; i < points.Size(); i++) {
+      out[i] = Polygon::ContainsPoint(Point(points.x[i], points.y[i]));
+    }
+  }
+
+  void Polygon::CrossesSegments(const SegmentBuffer& segments,
+                                std::span<uint8_t> out) const {
+    size_t i = 0;
+#if defined(__x86_64__)
+    if (batch::UseAvx2()) {
+      i = batch::PolygonCrosses(points_, segments, out.data());
+    }
+#endif
+    for (; i < segments.Size(); i++) {
+      out[i] = Polygon::CrossesSegment(
+              Segment(Point(segments.x1[i], segments.y1[i]),
+                      Point(segments.x2[i], segments.y2[i])));
+    }
+  }
+
 /////////////////////////////////////Circle/////////////////////////////////////
   Circle::Circle(const Point& center, int radius)
           : center_(center), radius_(radius) {}
@@ -512,7 +1495,7 @@ namespace Geometry {
   bool Circle::ContainsPoint(const Point& point) const {
     return (long long)(center_.coordinate.x - point.coordinate.x) *
            (center_.coordinate.x - point.coordinate.x) +
-           (center_.coordinate.y - point.coordinate.y) *
+           (long long)(center_.coordinate.y - point.coordinate.y) *
            (center_.coordinate.y - point.coordinate.y) <=
            (long long)radius_ * radius_;
   }
@@ -543,7 +1526,11 @@ namespace Geometry {
 
   std::string Circle::ToString() const {
     std::string output = "Circle(";
-    output += center_.ToString() + ", " + std::to_string(radius_) + ")";
+    output.reserve(48);
+    AppendPoint(output, center_.coordinate);
+    output += ", ";
+    AppendNumber(output, radius_);
+    output += ')';
     return output;
   }
 
@@ -551,4 +1538,625 @@ namespace Geometry {
     auto* clone = new Circle(center_, radius_);
     return clone;
   }
+
+  std::optional<Box> Circle::BoundingBox() const {
+    Box box;
+    box.Extend(center_.coordinate - Vector(radius_, radius_));
+    box.Extend(center_.coordinate + Vector(radius_, radius_));
+    return box;
+  }
+
+  void Circle::ContainsPoints(const PointBuffer& points,
+                              std::span<uint8_t> out) const {
+    size_t i = 0;
+#if defined(__x86_64__)
+    if (batch::UseAvx2()) {
+      i = batch::CircleContains(center_.coordinate, radius_, points,
+                                out.data());
+    }
+#endif
+    for (; i < points.Size(); i++) {
+      out[i] = Circle::ContainsPoint(Point(points.x[i], points.y[i]));
+    }
+  }
+
+  // The exact intersection points need a square root, so there is no
+  // kernel; the override only saves the virtual calls.
+  void Circle::CrossesSegments(const SegmentBuffer& segments,
+                               std::span<uint8_t> out) const {
+    for (size_t i = 0; i < segments.Size(); i++) {
+      out[i] = Circle::CrossesSegment(
+              Segment(Point(segments.x1[i], segments.y1[i]),
+                      Point(segments.x2[i], segments.y2[i])));
+    }
+  }
+
+/////////////////////////////////PreparedPolygon////////////////////////////////
+  PreparedPolygon::PreparedPolygon(const Polygon& polygon)
+          : polygon_(polygon) {
+    if (BuildConvex()) {
+      mode_ = Mode::kConvex;
+    } else if (BuildSlabs()) {
+      mode_ = Mode::kSlabs;
+    }
+  }
+
+  // Drops repeated vertices and the middle one of three collinear ones,
+  // then checks that every turn goes the same way and that the edges turn
+  // around only once (their x direction changes sign exactly twice).
+  bool PreparedPolygon::BuildConvex() {
+    std::vector<Vector> hull;
+    auto dot = [](const Vector& a, const Vector& b, const Vector& c) {
+      return (long long)(b.x - a.x) * (c.x - b.x) +
+             (long long)(b.y - a.y) * (c.y - b.y);
+    };
+    // Pops collinear vertices before v; false on a spike that goes back.
+    auto push = [&](const Vector& v) {
+      if (!hull.empty() && hull.back() == v) {
+        return true;
+      }
+      while (hull.size() >= 2 &&
+             Cross(hull[hull.size() - 2], hull.back(), v) == 0) {
+        if (dot(hull[hull.size() - 2], hull.back(), v) < 0) {
+          return false;
+        }
+        hull.pop_back();
+      }
+      hull.push_back(v);
+      return true;
+    };
+    for (const auto& point : polygon_.GetPoints()) {
+      if (!push(point.coordinate)) {
+        return false;
+      }
+    }
+    // The same at the seam between the last and the first vertex.
+    for (size_t i = 0; i < 2 && hull.size() >= 3; i++) {
+      Vector first = hull.front();
+      hull.erase(hull.begin());
+      if (!push(first)) {
+        return false;
+      }
+    }
+    size_t n = hull.size();
+    if (n < 3) {
+      return false;
+    }
+    int turn = Sign(Cross(hull[0], hull[1], hull[2]));
+    int sign_changes = 0;
+    int last_dx = 0;
+    for (size_t i = 0; i < n; i++) {
+      const Vector& a = hull[i];
+      const Vector& b = hull[(i + 1) % n];
+      if (Sign(Cross(a, b, hull[(i + 2) % n])) != turn) {
+        return false;
+      }
+      int dx = Sign(b.x - a.x);
+      if (dx != 0) {
+        sign_changes += (last_dx != 0 && dx != last_dx);
+        last_dx = dx;
+      }
+    }
+    int first_dx = 0;
+    for (size_t i = 0; i < n && first_dx == 0; i++) {
+      first_dx = Sign(hull[(i + 1) % n].x - hull[i].x);
+    }
+    sign_changes += (first_dx != last_dx);
+    if (sign_changes != 2) {
+      return false;
+    }
+    if (turn < 0) {
+      std::reverse(hull.begin(), hull.end());
+    }
+    convex_ = std::move(hull);
+    return true;
+  }
+
+  bool PreparedPolygon::BuildSlabs() {
+    std::span<const Point> points = polygon_.GetPoints();
+    size_t n = points.size();
+    if (n == 0) {
+      return false;
+    }
+    for (const auto& point : points) {
+      slab_x_.push_back(point.coordinate.x);
+      bounds_.push_back(
+              {point.coordinate.x, point.coordinate.y, point.coordinate.y});
+    }
+    std::sort(slab_x_.begin(), slab_x_.end());
+    slab_x_.erase(std::unique(slab_x_.begin(), slab_x_.end()), slab_x_.end());
+    for (size_t i = 0; i < n; i++) {
+      Vector a = points[i == 0 ? n - 1 : i - 1].coordinate;
+      Vector b = points[i].coordinate;
+      if (a.x == b.x) {
+        bounds_.push_back({a.x, std::min(a.y, b.y), std::max(a.y, b.y)});
+        continue;
+      }
+      if (a.x > b.x) {
+        std::swap(a, b);
+      }
+      edges_.push_back({a, b});
+    }
+
+    // Sweeps the borders from left to right: the edges ending on a border
+    // leave the tree, ordered as in the slab before it, then the edges
+    // starting there join it, ordered as in the slab after it. A polygon
+    // with crossing edges has two of them next to each other in the tree
+    // before the sweep passes their leftmost crossing.
+    std::vector<uint32_t> by_l(edges_.size());
+    for (uint32_t i = 0; i < by_l.size(); i++) {
+      by_l[i] = i;
+    }
+    std::vector<uint32_t> by_r = by_l;
+    std::sort(by_l.begin(), by_l.end(), [&](uint32_t first, uint32_t second) {
+      return edges_[first].l.x < edges_[second].l.x;
+    });
+    std::sort(by_r.begin(), by_r.end(), [&](uint32_t first, uint32_t second) {
+      return edges_[first].r.x < edges_[second].r.x;
+    });
+    nodes_.push_back({0, 0, 0, 0});
+    roots_.assign(slab_x_.size(), 0);
+    uint32_t root = 0;
+    size_t next_l = 0;
+    size_t next_r = 0;
+    for (size_t i = 0; i + 1 < slab_x_.size(); i++) {
+      for (; next_r < by_r.size() && edges_[by_r[next_r]].r.x == slab_x_[i];
+           next_r++) {
+        uint32_t less = 0;
+        uint32_t rest = 0;
+        Split(root, by_r[next_r], (long long)slab_x_[i - 1] + slab_x_[i],
+              less, rest);
+        rest = EraseFirst(rest);
+        if (Crosses(Last(less), First(rest))) {
+          return false;
+        }
+        root = Merge(less, rest);
+      }
+      for (; next_l < by_l.size() && edges_[by_l[next_l]].l.x == slab_x_[i];
+           next_l++) {
+        uint32_t less = 0;
+        uint32_t rest = 0;
+        Split(root, by_l[next_l], (long long)slab_x_[i] + slab_x_[i + 1],
+              less, rest);
+        uint32_t node = Add({by_l[next_l], 0, 0, 0});
+        if (Crosses(Last(less), node) || Crosses(node, First(rest))) {
+          return false;
+        }
+        root = Merge(Merge(less, node), rest);
+      }
+      roots_[i] = root;
+    }
+
+    std::sort(bounds_.begin(), bounds_.end(),
+              [](const Bound& first, const Bound& second) {
+                return first.x < second.x ||
+                       (first.x == second.x && first.low < second.low);
+              });
+    std::vector<Bound> merged;
+    for (const Bound& bound : bounds_) {
+      if (!merged.empty() && merged.back().x == bound.x &&
+          merged.back().high >= bound.low) {
+        merged.back().high = std::max(merged.back().high, bound.high);
+      } else {
+        merged.push_back(bound);
+      }
+    }
+    bounds_ = std::move(merged);
+    return true;
+  }
+
+  IShape& PreparedPolygon::Move(const Vector& vector) {
+    polygon_.Move(vector);
+    offset_ += vector;
+    return *this;
+  }
+
+  bool PreparedPolygon::ContainsPoint(const Point& point) const {
+    switch (mode_) {
+      case Mode::kConvex:
+        return ContainsConvex(point.coordinate - offset_);
+      case Mode::kSlabs:
+        return ContainsSlabs(point.coordinate - offset_);
+      default:
+        return polygon_.ContainsPoint(point);
+    }
+  }
+
+  // The point must lie in the angle at convex_[0] between its two edges;
+  // the fan triangle it falls into is found by a binary search, and its
+  // outer edge decides.
+  bool PreparedPolygon::ContainsConvex(const Vector& point) const {
+    const std::vector<Vector>& v = convex_;
+    if (Cross(v[0], v[1], point) < 0 || Cross(v[0], v.back(), point) > 0) {
+      return false;
+    }
+    size_t lo = 1;
+    size_t hi = v.size() - 1;
+    while (hi - lo > 1) {
+      size_t mid = (lo + hi) / 2;
+      if (Cross(v[0], v[mid], point) >= 0) {
+        lo = mid;
+      } else {
+        hi = mid;
+      }
+    }
+    return Cross(v[lo], v[hi], point) >= 0;
+  }
+
+  bool PreparedPolygon::ContainsSlabs(const Vector& point) const {
+    auto slab = std::upper_bound(slab_x_.begin(), slab_x_.end(), point.x);
+    if (slab == slab_x_.begin()) {
+      return false;
+    }
+    size_t i = slab - slab_x_.begin() - 1;
+    if (slab_x_[i] == point.x) {
+      auto bound = std::upper_bound(
+              bounds_.begin(), bounds_.end(), point,
+              [](const Vector& p, const Bound& b) {
+                return p.x < b.x || (p.x == b.x && p.y < b.low);
+              });
+      if (bound != bounds_.begin() && bound[-1].x == point.x &&
+          bound[-1].high >= point.y) {
+        return true;
+      }
+    }
+    if (i + 1 == slab_x_.size()) {
+      return false;
+    }
+    size_t below = 0;
+    uint32_t node = roots_[i];
+    while (node != 0) {
+      const Edge& edge = edges_[nodes_[node].edge];
+      long long side = Cross(edge.l, edge.r, point);
+      if (side == 0) {
+        return true;
+      }
+      if (side > 0) {
+        below += nodes_[nodes_[node].left].size + 1;
+        node = nodes_[node].right;
+      } else {
+        node = nodes_[node].left;
+      }
+    }
+    return below % 2 == 1;
+  }
+
+  bool PreparedPolygon::CrossesSegment(const Segment& seg) const {
+    return polygon_.CrossesSegment(seg);
+  }
+
+  std::string PreparedPolygon::ToString() const { return polygon_.ToString(); }
+
+  IShape* PreparedPolygon::Clone() const {
+    auto* clone = new PreparedPolygon(*this);
+    return clone;
+  }
+
+  std::optional<Box> PreparedPolygon::BoundingBox() const {
+    return polygon_.BoundingBox();
+  }
+
+  const Polygon& PreparedPolygon::GetPolygon() const { return polygon_; }
+
+  // Both sides are brought to the common denominator, so the comparison
+  // is exact.
+  int PreparedPolygon::CompareAt(const Edge& first, const Edge& second,
+                                 long long x2) {
+    auto numerator = [x2](const Edge& edge) {
+      return (__int128)2 * edge.l.y * (edge.r.x - edge.l.x) +
+             (__int128)(edge.r.y - edge.l.y) * (x2 - 2LL * edge.l.x);
+    };
+    __int128 diff = numerator(first) * (second.r.x - second.l.x) -
+                    numerator(second) * (first.r.x - first.l.x);
+    return (diff == 0 ? 0 : (diff < 0 ? -1 : 1));
+  }
+
+  uint32_t PreparedPolygon::Priority(uint32_t edge) {
+    uint32_t hash = edge * 0x9e3779b9u;
+    hash ^= hash >> 16;
+    hash *= 0x85ebca6bu;
+    hash ^= hash >> 13;
+    return hash;
+  }
+
+  bool PreparedPolygon::Less(uint32_t first, uint32_t second,
+                             long long x2) const {
+    int order = CompareAt(edges_[first], edges_[second], x2);
+    return order < 0 || (order == 0 && first < second);
+  }
+
+  // Edges touching at an end meet on a slab border, where the tree
+  // changes anyway; only a crossing strictly inside both breaks the
+  // order of a slab.
+  bool PreparedPolygon::Crosses(uint32_t first, uint32_t second) const {
+    if (first == 0 || second == 0) {
+      return false;
+    }
+    const Edge& a = edges_[nodes_[first].edge];
+    const Edge& b = edges_[nodes_[second].edge];
+    return Sign(Cross(a.l, a.r, b.l)) * Sign(Cross(a.l, a.r, b.r)) < 0 &&
+           Sign(Cross(b.l, b.r, a.l)) * Sign(Cross(b.l, b.r, a.r)) < 0;
+  }
+
+  uint32_t PreparedPolygon::Add(Node node) {
+    node.size = nodes_[node.left].size + nodes_[node.right].size + 1;
+    nodes_.push_back(node);
+    return nodes_.size() - 1;
+  }
+
+  // Copies the nodes on the search path, leaving the old tree intact.
+  void PreparedPolygon::Split(uint32_t root, uint32_t edge, long long x2,
+                              uint32_t& less, uint32_t& rest) {
+    if (root == 0) {
+      less = 0;
+      rest = 0;
+      return;
+    }
+    Node node = nodes_[root];
+    if (Less(node.edge, edge, x2)) {
+      Split(node.right, edge, x2, node.right, rest);
+      less = Add(node);
+    } else {
+      Split(node.left, edge, x2, less, node.left);
+      rest = Add(node);
+    }
+  }
+
+  uint32_t PreparedPolygon::Merge(uint32_t first, uint32_t second) {
+    if (first == 0 || second == 0) {
+      return first + second;
+    }
+    if (Priority(nodes_[first].edge) > Priority(nodes_[second].edge)) {
+      Node node = nodes_[first];
+      node.right = Merge(node.right, second);
+      return Add(node);
+    }
+    Node node = nodes_[second];
+    node.left = Merge(first, node.left);
+    return Add(node);
+  }
+
+  uint32_t PreparedPolygon::EraseFirst(uint32_t root) {
+    Node node = nodes_[root];
+    if (node.left == 0) {
+      return node.right;
+    }
+    node.left = EraseFirst(node.left);
+    return Add(node);
+  }
+
+  uint32_t PreparedPolygon::First(uint32_t root) const {
+    while (root != 0 && nodes_[root].left != 0) {
+      root = nodes_[root].left;
+    }
+    return root;
+  }
+
+  uint32_t PreparedPolygon::Last(uint32_t root) const {
+    while (root != 0 && nodes_[root].right != 0) {
+      root = nodes_[root].right;
+    }
+    return root;
+  }
+
+////////////////////////////////////ShapeIndex//////////////////////////////////
+  ShapeIndex::ShapeIndex(const std::vector<IShape*>& shapes)
+          : shapes_(shapes) {
+    for (size_t i = 0; i < shapes_.size(); i++) {
+      std::optional<Box> box = shapes_[i]->BoundingBox();
+      if (!box) {
+        unbounded_.push_back(i);
+      } else if (!box->Empty()) {
+        items_.push_back({*box, i});
+      }
+    }
+    if (items_.empty()) {
+      return;
+    }
+    SortTiles(items_);
+    std::vector<Node> level;
+    for (size_t begin = 0; begin < items_.size(); begin += kNodeSize) {
+      Node node{Box(), begin, std::min(begin + kNodeSize, items_.size()),
+                true};
+      for (size_t i = node.begin; i < node.end; i++) {
+        node.box.Extend(items_[i].box);
+      }
+      level.push_back(node);
+    }
+    while (true) {
+      std::vector<Entry> entries;
+      for (size_t i = 0; i < level.size(); i++) {
+        entries.push_back({level[i].box, i});
+      }
+      SortTiles(entries);
+      size_t offset = nodes_.size();
+      for (const Entry& entry : entries) {
+        nodes_.push_back(level[entry.index]);
+      }
+      if (entries.size() == 1) {
+        break;
+      }
+      level.clear();
+      for (size_t begin = 0; begin < entries.size(); begin += kNodeSize) {
+        Node node{Box(), offset + begin,
+                  offset + std::min(begin + kNodeSize, entries.size()),
+                  false};
+        for (size_t i = node.begin; i < node.end; i++) {
+          node.box.Extend(nodes_[i].box);
+        }
+        level.push_back(node);
+      }
+    }
+  }
+
+  void ShapeIndex::SortTiles(std::vector<Entry>& entries) {
+    auto center_x = [](const Entry& entry) {
+      return (long long)entry.box.min_x + entry.box.max_x;
+    };
+    auto center_y = [](const Entry& entry) {
+      return (long long)entry.box.min_y + entry.box.max_y;
+    };
+    size_t runs = (entries.size() + kNodeSize - 1) / kNodeSize;
+    size_t slices = std::ceil(std::sqrt((double)runs));
+    size_t slice_size = (runs + slices - 1) / slices * kNodeSize;
+    std::sort(entries.begin(), entries.end(),
+              [&](const Entry& first, const Entry& second) {
+                return center_x(first) < center_x(second);
+              });
+    for (size_t begin = 0; begin < entries.size(); begin += slice_size) {
+      std::sort(entries.begin() + begin,
+                entries.begin() + std::min(begin + slice_size, entries.size()),
+                [&](const Entry& first, const Entry& second) {
+                  return center_y(first) < center_y(second);
+                });
+    }
+  }
+
+  template <typename BoxTest, typename Visit>
+  void ShapeIndex::Search(BoxTest box_test, Visit visit) const {
+    if (nodes_.empty() || !box_test(nodes_.back().box)) {
+      return;
+    }
+    std::vector<size_t> stack = {nodes_.size() - 1};
+    while (!stack.empty()) {
+      const Node& node = nodes_[stack.back()];
+      stack.pop_back();
+      for (size_t i = node.begin; i < node.end; i++) {
+        if (node.leaf) {
+          if (box_test(items_[i].box)) {
+            visit(items_[i].index);
+          }
+        } else if (box_test(nodes_[i].box)) {
+          stack.push_back(i);
+        }
+      }
+    }
+  }
+
+  std::vector<size_t> ShapeIndex::ShapesContaining(const Point& point) const {
+    std::vector<size_t> res;
+    for (size_t index : unbounded_) {
+      if (shapes_[index]->ContainsPoint(point)) {
+        res.push_back(index);
+      }
+    }
+    Search(
+            [&point](const Box& box) {
+              return box.ContainsPoint(point.coordinate);
+            },
+            [&](size_t index) {
+              if (shapes_[index]->ContainsPoint(point)) {
+                res.push_back(index);
+              }
+            });
+    std::sort(res.begin(), res.end());
+    return res;
+  }
+
+  std::vector<size_t> ShapeIndex::ShapesCrossing(const Segment& seg) const {
+    std::vector<size_t> res;
+    for (size_t index : unbounded_) {
+      if (shapes_[index]->CrossesSegment(seg)) {
+        res.push_back(index);
+      }
+    }
+    Vector l = seg.GetL().coordinate;
+    Vector r = seg.GetR().coordinate;
+    Search(
+            [&l, &r](const Box& box) { return box.CrossesSegment(l, r); },
+            [&](size_t index) {
+              if (shapes_[index]->CrossesSegment(seg)) {
+                res.push_back(index);
+              }
+            });
+    std::sort(res.begin(), res.end());
+    return res;
+  }
+
+  size_t ShapeIndex::Size() const { return shapes_.size(); }
+
+//////////////////////////////////////Shape/////////////////////////////////////
+  Shape& Shape::Move(const Vector& vector) {
+    std::visit([&vector](auto& shape) { shape.Move(vector); }, shape_);
+    return *this;
+  }
+
+  bool Shape::ContainsPoint(const Point& point) const {
+    return std::visit(
+            [&point](const auto& shape) { return shape.ContainsPoint(point); },
+            shape_);
+  }
+
+  bool Shape::CrossesSegment(const Segment& seg) const {
+    return std::visit(
+            [&seg](const auto& shape) { return shape.CrossesSegment(seg); },
+            shape_);
+  }
+
+  std::string Shape::ToString() const {
+    return std::visit([](const auto& shape) { return shape.ToString(); },
+                      shape_);
+  }
+
+  std::optional<Box> Shape::BoundingBox() const {
+    return std::visit([](const auto& shape) { return shape.BoundingBox(); },
+                      shape_);
+  }
+
+  const Shape::Variant& Shape::GetVariant() const { return shape_; }
+
+///////////////////////////////////ShapeVector//////////////////////////////////
+  template <typename T>
+  void ShapeVector<T>::Push(const T& shape) {
+    if constexpr (std::is_same_v<T, Polygon>) {
+      if (pool_ == nullptr) {
+        pool_ = std::make_unique<std::pmr::unsynchronized_pool_resource>();
+      }
+      shapes_.emplace_back(shape, pool_.get());
+    } else {
+      shapes_.push_back(shape);
+    }
+  }
+
+  template <typename T>
+  size_t ShapeVector<T>::Size() const {
+    return shapes_.size();
+  }
+
+  template <typename T>
+  const T& ShapeVector<T>::operator[](size_t index) const {
+    return shapes_[index];
+  }
+
+  template <typename T>
+  ShapeVector<T>& ShapeVector<T>::Move(const Vector& vector) {
+    for (auto& shape : shapes_) {
+      shape.Move(vector);
+    }
+    return *this;
+  }
+
+  template <typename T>
+  std::vector<size_t> ShapeVector<T>::ShapesContaining(
+          const Point& point) const {
+    std::vector<size_t> res;
+    for (size_t i = 0; i < shapes_.size(); i++) {
+      if (shapes_[i].ContainsPoint(point)) {
+        res.push_back(i);
+      }
+    }
+    return res;
+  }
+
+  template <typename T>
+  std::vector<size_t> ShapeVector<T>::ShapesCrossing(const Segment& seg) const {
+    std::vector<size_t> res;
+    for (size_t i = 0; i < shapes_.size(); i++) {
+      if (shapes_[i].CrossesSegment(seg)) {
+        res.push_back(i);
+      }
+    }
+    return res;
+  }
+
 }  // namespace Geometry
@@ -0,0 +1,67 @@
+#include "Arena.hpp"
+
+#include <memory>
+
+Arena::Arena(size_t block_size, std::pmr::memory_resource* upstream)
+    : upstream_(upstream),
+      block_size_(block_size),
+      blocks_(nullptr),
+      current_(nullptr),
+      end_(nullptr),
+      used_(0),
+      reserved_(0) {}
+
+Arena::~Arena() { Release(); }
+
+void Arena::Release() {
+  while (blocks_ != nullptr) {
+    Block* next = blocks_->next;
+    upstream_->deallocate(blocks_, blocks_->size, alignof(Block));
+    blocks_ = next;
+  }
+  current_ = end_ = nullptr;
+  used_ = reserved_ = 0;
+}
+
+size_t Arena::BytesUsed() const { return used_; }
+
+size_t Arena::BytesReserved() const { return reserved_; }
+
+void* Arena::do_allocate(size_t bytes, size_t alignment) {
+  void* ptr = current_;
+  size_t space = end_ - current_;
+  if (std::align(alignment, bytes, ptr, space) == nullptr) {
+    AddBlock(bytes + alignment);
+    ptr = current_;
+    space = end_ - current_;
+    std::align(alignment, bytes, ptr, space);
+  }
+  current_ = (char*)ptr + bytes;
+  used_ += bytes;
+  return ptr;
+}
+
+void Arena::do_deallocate(void* ptr, size_t bytes, size_t /*alignment*/) {
+  if ((char*)ptr + bytes == current_) {
+    current_ = (char*)ptr;
+  }
+  used_ -= bytes;
+}
+
+bool Arena::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+  return this == &other;
+}
+
+void Arena::AddBlock(size_t min_size) {
+  size_t size = sizeof(Block) + min_size;
+  if (size < block_size_) {
+    size = block_size_;
+  }
+  Block* block = (Block*)upstream_->allocate(size, alignof(Block));
+  block->next = blocks_;
+  block->size = size;
+  blocks_ = block;
+  current_ = (char*)(block + 1);
+  end_ = (char*)block + size;
+  reserved_ += size;
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <memory_resource>
+
+// Bump allocator for per-request strings. Allocation moves a pointer
+// through large blocks taken from the upstream resource; deallocation is
+// a no-op except for the most recent allocation, which is rolled back.
+// Release() (or the destructor) returns every block at once.
+class Arena : public std::pmr::memory_resource {
+ public:
+  static const size_t kDefaultBlockSize = 64 * 1024;
+
+  explicit Arena(size_t block_size = kDefaultBlockSize,
+                 std::pmr::memory_resource* upstream =
+                     std::pmr::new_delete_resource());
+
+  Arena(const Arena& other) = delete;
+  Arena& operator=(const Arena& other) = delete;
+
+  ~Arena() override;
+
+  // Everything allocated from the arena must be dead before this call.
+  void Release();
+
+  // Bytes currently handed out, not counting alignment padding.
+  [[nodiscard]] size_t BytesUsed() const;
+
+  // Bytes held in blocks taken from upstream.
+  [[nodiscard]] size_t BytesReserved() const;
+
+ private:
+  struct Block {
+    Block* next;
+    size_t size;
+  };
+
+  void* do_allocate(size_t bytes, size_t alignment) override;
+
+  void do_deallocate(void* ptr, size_t bytes, size_t alignment) override;
+
+  [[nodiscard]] bool do_is_equal(
+      const std::pmr::memory_resource& other) const noexcept override;
+
+  void AddBlock(size_t min_size);
+
+  std::pmr::memory_resource* upstream_;
+  size_t block_size_;
+  Block* blocks_;
+  char* current_;
+  char* end_;
+  size_t used_;
+  size_t reserved_;
+};
@@ -0,0 +1,193 @@
+#pragma once
+
+#include <algorithm>
+#include <concepts>
+#include <ranges>
+#include <vector>
+
+#include "String.hpp"
+#include "StringHash.hpp"
+
+// String literal with its length in the type. Everything but the
+// conversion to StringView is constexpr, so tables of FixedStrings are
+// laid out by the compiler instead of being built at startup, and the
+// type can be a template argument: SplitView<",">(line) is compiled for a
+// one-byte delimiter. Hash() matches String::Hash() of the same text.
+template <size_t N>
+struct FixedString {
+  constexpr FixedString() = default;
+
+  constexpr FixedString(const char (&str)[N + 1]) {
+    std::copy_n(str, N + 1, data);
+  }
+
+  [[nodiscard]] static constexpr size_t Size() { return N; }
+
+  [[nodiscard]] static constexpr bool Empty() { return N == 0; }
+
+  [[nodiscard]] constexpr const char* Data() const { return data; }
+
+  constexpr char operator[](size_t index) const { return data[index]; }
+
+  [[nodiscard]] constexpr size_t Hash() const { return HashBytes(data, N); }
+
+  operator StringView() const { return {data, N}; }
+
+  // Same result as String::Join with this separator.
+  template <std::ranges::forward_range Range>
+    requires std::convertible_to<std::ranges::range_reference_t<Range>,
+                                 StringView>
+  [[nodiscard]] String Join(Range&& strings) const;
+
+  // Public, as template arguments need structural types. NUL-terminated.
+  char data[N + 1] = {};
+};
+
+template <size_t N>
+FixedString(const char (&)[N]) -> FixedString<N - 1>;
+
+namespace fixed_string {
+
+// Position of the first occurrence of Needle in data[pos, size), kNpos if
+// there is none. Candidates come from memchr on the first byte and are
+// confirmed with a memcmp whose length is a constant.
+template <FixedString Needle>
+size_t Find(const char* data, size_t size, size_t pos) {
+  static_assert(!Needle.Empty());
+  constexpr size_t kRest = Needle.Size() - 1;
+  while (pos + kRest < size) {
+    const char* found = static_cast<const char*>(
+        memchr(data + pos, Needle[0], size - pos - kRest));
+    if (found == nullptr) {
+      return StringView::kNpos;
+    }
+    if (memcmp(found + 1, Needle.Data() + 1, kRest) == 0) {
+      return found - data;
+    }
+    pos = found - data + 1;
+  }
+  return StringView::kNpos;
+}
+
+}  // namespace fixed_string
+
+// Same tokens as StringView::Split(Delim).
+template <FixedString Delim>
+[[nodiscard]] std::vector<StringView> SplitView(StringView str) {
+  std::vector<StringView> tokens;
+  size_t begin = 0;
+  if constexpr (!Delim.Empty()) {
+    for (size_t pos = fixed_string::Find<Delim>(str.Data(), str.Size(), 0);
+         pos != StringView::kNpos;
+         pos = fixed_string::Find<Delim>(str.Data(), str.Size(), begin)) {
+      tokens.push_back(str.Substr(begin, pos - begin));
+      begin = pos + Delim.Size();
+    }
+  }
+  tokens.push_back(str.Substr(begin, str.Size() - begin));
+  return tokens;
+}
+
+// Same tokens as String::Split(Delim).
+template <FixedString Delim>
+[[nodiscard]] std::vector<String> Split(StringView str) {
+  std::vector<StringView> views = SplitView<Delim>(str);
+  std::vector<String> strings;
+  strings.reserve(views.size());
+  for (StringView view : views) {
+    strings.emplace_back(view);
+  }
+  return strings;
+}
+
+template <size_t N>
+template <std::ranges::forward_range Range>
+  requires std::convertible_to<std::ranges::range_reference_t<Range>,
+                               StringView>
+String FixedString<N>::Join(Range&& strings) const {
+  size_t count = 0;
+  size_t total = 0;
+  for (StringView str : strings) {
+    total += str.Size();
+    ++count;
+  }
+  if (count != 0) {
+    total += (count - 1) * N;
+  }
+  String res;
+  res.Reserve(total);
+  bool first = true;
+  for (StringView str : strings) {
+    if (!first) {
+      res.Append(data, N);
+    }
+    res.Append(str.Data(), str.Size());
+    first = false;
+  }
+  return res;
+}
+
+template <size_t N, size_t M>
+constexpr FixedString<N + M> operator+(const FixedString<N>& first,
+                                       const FixedString<M>& second) {
+  FixedString<N + M> res;
+  std::copy_n(first.data, N, res.data);
+  std::copy_n(second.data, M + 1, res.data + N);
+  return res;
+}
+
+template <size_t N>
+String operator+(const FixedString<N>& first, const String& second) {
+  String res;
+  res.Reserve(N + second.Size());
+  res.Append(first.Data(), N);
+  res.Append(second);
+  return res;
+}
+
+template <size_t N>
+String operator+(const String& first, const FixedString<N>& second) {
+  String res;
+  res.Reserve(first.Size() + N);
+  res.Append(first);
+  res.Append(second.Data(), N);
+  return res;
+}
+
+template <size_t N>
+String operator+(String&& first, const FixedString<N>& second) {
+  first.Append(second.Data(), N);
+  return std::move(first);
+}
+
+// Comparisons with String, StringView and C strings go through the
+// StringView operators.
+template <size_t N, size_t M>
+constexpr bool operator==(const FixedString<N>& first,
+                          const FixedString<M>& second) {
+  return N == M && std::equal(first.data, first.data + N, second.data);
+}
+
+template <size_t N, size_t M>
+constexpr bool operator!=(const FixedString<N>& first,
+                          const FixedString<M>& second) {
+  return !(first == second);
+}
+
+template <size_t N, size_t M>
+constexpr bool operator<(const FixedString<N>& first,
+                         const FixedString<M>& second) {
+  return std::lexicographical_compare(
+      first.data, first.data + N, second.data, second.data + M,
+      [](char a, char b) { return (unsigned char)a < (unsigned char)b; });
+}
+
+template <size_t N>
+std::ostream& operator<<(std::ostream& out, const FixedString<N>& str) {
+  return out.write(str.Data(), N);
+}
+
+template <size_t N>
+struct std::hash<FixedString<N>> {
+  size_t operator()(const FixedString<N>& str) const { return str.Hash(); }
+};
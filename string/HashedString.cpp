@@ -0,0 +1,27 @@
+#include "HashedString.hpp"
+
+HashedString::HashedString() : hash_(str_.Hash()) {}
+
+HashedString::HashedString(String str)
+    : str_(std::move(str)), hash_(str_.Hash()) {}
+
+HashedString::HashedString(StringView view)
+    : str_(view), hash_(str_.Hash()) {}
+
+const String& HashedString::Get() const { return str_; }
+
+size_t HashedString::Hash() const { return hash_; }
+
+HashedString::operator StringView() const { return str_; }
+
+bool operator==(const HashedString& first, const HashedString& second) {
+  return first.Hash() == second.Hash() && first.Get() == second.Get();
+}
+
+bool operator!=(const HashedString& first, const HashedString& second) {
+  return !(first == second);
+}
+
+bool operator<(const HashedString& first, const HashedString& second) {
+  return first.Get() < second.Get();
+}
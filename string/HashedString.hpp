@@ -0,0 +1,36 @@
+#pragma once
+
+#include "String.hpp"
+
+// Immutable String key that computes its hash once. Meant for keys that
+// are hashed and compared many times; equality checks the cached hashes
+// before looking at the characters.
+class HashedString {
+ public:
+  HashedString();
+
+  explicit HashedString(String str);
+
+  explicit HashedString(StringView view);
+
+  [[nodiscard]] const String& Get() const;
+
+  [[nodiscard]] size_t Hash() const;
+
+  operator StringView() const;
+
+ private:
+  String str_;
+  size_t hash_;
+};
+
+bool operator==(const HashedString& first, const HashedString& second);
+
+bool operator!=(const HashedString& first, const HashedString& second);
+
+bool operator<(const HashedString& first, const HashedString& second);
+
+template <>
+struct std::hash<HashedString> {
+  size_t operator()(const HashedString& str) const { return str.Hash(); }
+};
@@ -0,0 +1,118 @@
+#include "InternPool.hpp"
+
+#include <mutex>
+
+/////////////////////////////////////Atom///////////////////////////////////////
+Atom::Atom() : entry_(nullptr) {}
+
+Atom::Atom(const Entry* entry) : entry_(entry) {}
+
+bool Atom::Valid() const { return entry_ != nullptr; }
+
+const String& Atom::Get() const {
+  static const String kEmpty;
+  return (entry_ != nullptr ? entry_->str : kEmpty);
+}
+
+size_t Atom::Hash() const {
+  return (entry_ != nullptr ? entry_->hash : StringView().Hash());
+}
+
+bool Atom::Empty() const { return Get().Empty(); }
+
+size_t Atom::Size() const { return Get().Size(); }
+
+const char* Atom::Data() const { return Get().Data(); }
+
+Atom::operator StringView() const { return Get(); }
+
+bool operator==(Atom first, Atom second) {
+  return first.entry_ == second.entry_;
+}
+
+bool operator!=(Atom first, Atom second) { return !(first == second); }
+
+bool operator<(Atom first, Atom second) {
+  return StringView(first) < StringView(second);
+}
+
+std::ostream& operator<<(std::ostream& out, Atom atom) {
+  return out << StringView(atom);
+}
+
+//////////////////////////////////InternPool////////////////////////////////////
+double InternPool::Stats::HitRate() const {
+  return (lookups != 0 ? (double)hits / lookups : 0);
+}
+
+InternPool::InternPool()
+    : shards_(new Shard[kShards]),
+      size_(0),
+      bytes_(0) {}
+
+InternPool& InternPool::Global() {
+  static InternPool pool;
+  return pool;
+}
+
+// The low hash bits pick the bucket inside a shard's table, so the shard
+// is picked by the high ones.
+size_t InternPool::ShardIndex(size_t hash) {
+  return (hash >> 56) % kShards;
+}
+
+Atom InternPool::Intern(StringView view) {
+  Key key{view, view.Hash()};
+  Shard& shard = shards_[ShardIndex(key.hash)];
+  shard.lookups.fetch_add(1, std::memory_order_relaxed);
+  {
+    std::shared_lock lock(shard.mutex);
+    auto it = shard.table.find(key);
+    if (it != shard.table.end()) {
+      shard.hits.fetch_add(1, std::memory_order_relaxed);
+      return Atom(it->second);
+    }
+  }
+  std::unique_lock lock(shard.mutex);
+  auto it = shard.table.find(key);
+  if (it != shard.table.end()) {
+    shard.hits.fetch_add(1, std::memory_order_relaxed);
+    return Atom(it->second);
+  }
+  const Atom::Entry& entry = shard.entries.emplace_back(
+      Atom::Entry{String(view), key.hash});
+  shard.table.emplace(Key{entry.str, key.hash}, &entry);
+  size_.fetch_add(1, std::memory_order_relaxed);
+  bytes_.fetch_add(view.Size(), std::memory_order_relaxed);
+  return Atom(&entry);
+}
+
+Atom InternPool::Find(StringView view) const {
+  Key key{view, view.Hash()};
+  const Shard& shard = shards_[ShardIndex(key.hash)];
+  shard.lookups.fetch_add(1, std::memory_order_relaxed);
+  std::shared_lock lock(shard.mutex);
+  auto it = shard.table.find(key);
+  if (it == shard.table.end()) {
+    return Atom();
+  }
+  shard.hits.fetch_add(1, std::memory_order_relaxed);
+  return Atom(it->second);
+}
+
+InternPool::Stats InternPool::GetStats() const {
+  Stats stats{size_.load(std::memory_order_relaxed),
+              bytes_.load(std::memory_order_relaxed), 0, 0};
+  for (size_t i = 0; i < kShards; ++i) {
+    stats.lookups += shards_[i].lookups.load(std::memory_order_relaxed);
+    stats.hits += shards_[i].hits.load(std::memory_order_relaxed);
+  }
+  return stats;
+}
+
+void InternPool::ResetStats() {
+  for (size_t i = 0; i < kShards; ++i) {
+    shards_[i].lookups.store(0, std::memory_order_relaxed);
+    shards_[i].hits.store(0, std::memory_order_relaxed);
+  }
+}
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <shared_mutex>
+#include <unordered_map>
+
+#include "String.hpp"
+
+// Handle to a string stored once in an InternPool. Atoms from the same
+// pool are equal exactly when their pointers are, and carry the hash that
+// was computed when the string was interned. An atom stays valid as long
+// as its pool does.
+class Atom {
+ public:
+  // An atom that refers to no string, as returned by a failed Find. It
+  // reads as the empty string but is not Valid().
+  Atom();
+
+  // False only for a default-constructed atom; an interned "" is valid.
+  [[nodiscard]] bool Valid() const;
+
+  [[nodiscard]] const String& Get() const;
+
+  [[nodiscard]] size_t Hash() const;
+
+  [[nodiscard]] bool Empty() const;
+
+  [[nodiscard]] size_t Size() const;
+
+  [[nodiscard]] const char* Data() const;
+
+  operator StringView() const;
+
+ private:
+  friend class InternPool;
+
+  struct Entry {
+    String str;
+    size_t hash;
+  };
+
+  explicit Atom(const Entry* entry);
+
+  const Entry* entry_;
+
+  friend bool operator==(Atom first, Atom second);
+};
+
+bool operator==(Atom first, Atom second);
+
+bool operator!=(Atom first, Atom second);
+
+// Orders atoms by their text, not by address.
+bool operator<(Atom first, Atom second);
+
+std::ostream& operator<<(std::ostream& out, Atom atom);
+
+template <>
+struct std::hash<Atom> {
+  size_t operator()(Atom atom) const { return atom.Hash(); }
+};
+
+// Thread-safe intern table. The table is split into kShards shards picked
+// by the string's hash; lookups of strings that are already interned only
+// take the shard's lock in shared mode. Lookup and hit counts are kept per
+// shard and summed by GetStats, so readers of different shards never
+// write to the same cache line.
+class InternPool {
+ public:
+  static const size_t kShards = 16;
+
+  struct Stats {
+    size_t size;
+    size_t bytes;
+    size_t lookups;
+    size_t hits;
+
+    [[nodiscard]] double HitRate() const;
+  };
+
+  InternPool();
+
+  InternPool(const InternPool& other) = delete;
+  InternPool& operator=(const InternPool& other) = delete;
+
+  // Process-wide pool for callers that do not need their own.
+  static InternPool& Global();
+
+  Atom Intern(StringView view);
+
+  // Returns the atom for view if it has been interned, an atom that is not
+  // Valid() otherwise. Never inserts.
+  [[nodiscard]] Atom Find(StringView view) const;
+
+  [[nodiscard]] Stats GetStats() const;
+
+  void ResetStats();
+
+ private:
+  static const size_t kCacheLine = 64;
+
+  struct Key {
+    StringView view;
+    size_t hash;
+  };
+
+  struct KeyHash {
+    size_t operator()(const Key& key) const { return key.hash; }
+  };
+
+  struct KeyEqual {
+    bool operator()(const Key& first, const Key& second) const {
+      return first.view == second.view;
+    }
+  };
+
+  struct alignas(kCacheLine) Shard {
+    mutable std::shared_mutex mutex;
+    std::unordered_map<Key, const Atom::Entry*, KeyHash, KeyEqual> table;
+    std::deque<Atom::Entry> entries;
+    // On a line of their own, away from the table that readers only load.
+    alignas(kCacheLine) mutable std::atomic<size_t> lookups{0};
+    mutable std::atomic<size_t> hits{0};
+  };
+
+  static size_t ShardIndex(size_t hash);
+
+  std::unique_ptr<Shard[]> shards_;
+  std::atomic<size_t> size_;
+  std::atomic<size_t> bytes_;
+};
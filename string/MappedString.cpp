@@ -0,0 +1,140 @@
+#include "MappedString.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+int AdviceFor(MappedString::Access access) {
+  switch (access) {
+    case MappedString::Access::kRandom:
+      return MADV_RANDOM;
+    case MappedString::Access::kWillNeed:
+      return MADV_WILLNEED;
+    default:
+      return MADV_SEQUENTIAL;
+  }
+}
+
+}  // namespace
+
+MappedString::MappedString() : data_(""), size_(0), open_(false) {}
+
+MappedString::MappedString(const char* path, Access access)
+    : MappedString() {
+  int fd = open(path, O_RDONLY | O_CLOEXEC);
+  if (fd == -1) {
+    return;
+  }
+  struct stat info;
+  if (fstat(fd, &info) == 0) {
+    // mmap rejects empty mappings, an empty file is just an empty string.
+    if (info.st_size == 0) {
+      open_ = true;
+    } else {
+      void* data = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (data != MAP_FAILED) {
+        data_ = static_cast<const char*>(data);
+        size_ = info.st_size;
+        open_ = true;
+        Advise(access);
+      }
+    }
+  }
+  // The mapping keeps the file alive without the descriptor.
+  close(fd);
+}
+
+MappedString::MappedString(MappedString&& other) noexcept
+    : data_(other.data_), size_(other.size_), open_(other.open_) {
+  other.data_ = "";
+  other.size_ = 0;
+  other.open_ = false;
+}
+
+MappedString& MappedString::operator=(MappedString&& other) noexcept {
+  if (this != &other) {
+    Close();
+    std::swap(data_, other.data_);
+    std::swap(size_, other.size_);
+    std::swap(open_, other.open_);
+  }
+  return *this;
+}
+
+MappedString::~MappedString() { Close(); }
+
+void MappedString::Close() {
+  if (size_ != 0) {
+    munmap(const_cast<char*>(data_), size_);
+  }
+  data_ = "";
+  size_ = 0;
+  open_ = false;
+}
+
+bool MappedString::IsOpen() const { return open_; }
+
+void MappedString::Advise(Access access) const {
+  if (size_ != 0) {
+    madvise(const_cast<char*>(data_), size_, AdviceFor(access));
+  }
+}
+
+char MappedString::operator[](size_t index) const { return data_[index]; }
+
+char MappedString::Front() const { return data_[0]; }
+
+char MappedString::Back() const { return data_[size_ - 1]; }
+
+bool MappedString::Empty() const { return size_ == 0; }
+
+size_t MappedString::Size() const { return size_; }
+
+const char* MappedString::Data() const { return data_; }
+
+MappedString::operator StringView() const { return {data_, size_}; }
+
+size_t MappedString::Hash() const { return StringView(*this).Hash(); }
+
+size_t MappedString::Find(StringView needle, size_t pos) const {
+  return StringView(*this).Find(needle, pos);
+}
+
+size_t MappedString::RFind(StringView needle, size_t pos) const {
+  return StringView(*this).RFind(needle, pos);
+}
+
+bool MappedString::Contains(StringView needle) const {
+  return StringView(*this).Contains(needle);
+}
+
+size_t MappedString::Count(StringView needle) const {
+  return StringView(*this).Count(needle);
+}
+
+bool MappedString::StartsWith(StringView prefix) const {
+  return StringView(*this).StartsWith(prefix);
+}
+
+bool MappedString::EndsWith(StringView suffix) const {
+  return StringView(*this).EndsWith(suffix);
+}
+
+std::vector<StringView> MappedString::SplitView(StringView delim) const {
+  return StringView(*this).Split(delim);
+}
+
+SplitRange MappedString::SplitLazy(StringView delim, size_t max_split) const {
+  return StringView(*this).SplitLazy(delim, max_split);
+}
+
+String MappedString::ToString(std::pmr::memory_resource* resource) const {
+  return String(StringView(*this), resource);
+}
+
+std::ostream& operator<<(std::ostream& out, const MappedString& str) {
+  return out << StringView(str);
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "String.hpp"
+
+// Read-only string backed by a file mapped with mmap. The characters are
+// paged in by the kernel on first access and never copied, so scanning a
+// file costs no more resident memory than the page cache already holds.
+// The mapping is private: later writes to the file by other processes may
+// or may not show through. Comparisons and hashing go through StringView.
+class MappedString {
+ public:
+  // Hint passed to madvise for the whole mapping.
+  enum class Access {
+    // Front-to-back scans: aggressive read-ahead, pages dropped early.
+    kSequential,
+    // Lookups all over the file: no read-ahead.
+    kRandom,
+    // Small files read many times: start paging everything in now.
+    kWillNeed,
+  };
+
+  MappedString();
+
+  // Like std::ifstream, a file that cannot be opened or mapped leaves the
+  // string closed and empty; check IsOpen() (errno tells why).
+  explicit MappedString(const char* path, Access access = Access::kSequential);
+
+  MappedString(const MappedString&) = delete;
+  MappedString& operator=(const MappedString&) = delete;
+
+  MappedString(MappedString&& other) noexcept;
+  MappedString& operator=(MappedString&& other) noexcept;
+
+  ~MappedString();
+
+  // Unmaps the file; the string becomes closed and empty.
+  void Close();
+
+  [[nodiscard]] bool IsOpen() const;
+
+  // Applies a new access hint, e.g. kRandom after an initial scan.
+  void Advise(Access access) const;
+
+  char operator[](size_t index) const;
+
+  [[nodiscard]] char Front() const;
+
+  [[nodiscard]] char Back() const;
+
+  [[nodiscard]] bool Empty() const;
+
+  [[nodiscard]] size_t Size() const;
+
+  // Not NUL-terminated.
+  [[nodiscard]] const char* Data() const;
+
+  operator StringView() const;
+
+  [[nodiscard]] size_t Hash() const;
+
+  [[nodiscard]] size_t Find(StringView needle, size_t pos = 0) const;
+
+  [[nodiscard]] size_t RFind(StringView needle,
+                             size_t pos = StringView::kNpos) const;
+
+  [[nodiscard]] bool Contains(StringView needle) const;
+
+  [[nodiscard]] size_t Count(StringView needle) const;
+
+  [[nodiscard]] bool StartsWith(StringView prefix) const;
+
+  [[nodiscard]] bool EndsWith(StringView suffix) const;
+
+  // The views point into the mapping and are invalidated by Close().
+  [[nodiscard]] std::vector<StringView> SplitView(
+      StringView delim = " ") const;
+
+  [[nodiscard]] SplitRange SplitLazy(StringView delim = " ",
+                                     size_t max_split = -1) const;
+
+  // Copies the contents into an owning, mutable String.
+  [[nodiscard]] String ToString(
+      std::pmr::memory_resource* resource = nullptr) const;
+
+ private:
+  const char* data_;
+  size_t size_;
+  bool open_;
+};
+
+std::ostream& operator<<(std::ostream& out, const MappedString& str);
+
+template <>
+struct std::hash<MappedString> {
+  size_t operator()(const MappedString& str) const { return str.Hash(); }
+};
@@ -0,0 +1,280 @@
+#include "Rope.hpp"
+
+#include <algorithm>
+
+// A leaf (left == nullptr) views size characters of text starting at
+// offset; several leaves may share one text after Substr.
+struct Rope::Node {
+  std::shared_ptr<const String> text;
+  size_t offset = 0;
+  NodePtr left;
+  NodePtr right;
+  size_t size = 0;
+  int height = 0;
+};
+
+////////////////////////////////ChunkIterator/////////////////////////////////
+Rope::ChunkIterator::ChunkIterator(const Rope& rope)
+    : rope_(&rope), in_tail_(false), done_(false) {
+  if (rope.root_ != nullptr) {
+    stack_.push_back(rope.root_.get());
+  }
+  Next();
+}
+
+Rope::ChunkIterator::ChunkIterator()
+    : rope_(nullptr), in_tail_(true), done_(true) {}
+
+StringView Rope::ChunkIterator::operator*() const { return chunk_; }
+
+Rope::ChunkIterator& Rope::ChunkIterator::operator++() {
+  Next();
+  return *this;
+}
+
+void Rope::ChunkIterator::operator++(int) { Next(); }
+
+bool Rope::ChunkIterator::operator==(std::default_sentinel_t) const {
+  return done_;
+}
+
+void Rope::ChunkIterator::Next() {
+  while (!stack_.empty()) {
+    const Node* node = stack_.back();
+    stack_.pop_back();
+    if (node->left == nullptr) {
+      chunk_ = StringView(node->text->Data() + node->offset, node->size);
+      return;
+    }
+    stack_.push_back(node->right.get());
+    stack_.push_back(node->left.get());
+  }
+  if (!in_tail_ && !rope_->tail_.Empty()) {
+    in_tail_ = true;
+    chunk_ = rope_->tail_;
+    return;
+  }
+  done_ = true;
+}
+
+Rope::ChunkRange::ChunkRange(const Rope& rope) : rope_(&rope) {}
+
+Rope::ChunkIterator Rope::ChunkRange::begin() const {
+  return ChunkIterator(*rope_);
+}
+
+std::default_sentinel_t Rope::ChunkRange::end() const {
+  return std::default_sentinel;
+}
+
+/////////////////////////////////////Tree///////////////////////////////////////
+int Rope::Height(const NodePtr& node) {
+  return (node == nullptr ? -1 : node->height);
+}
+
+size_t Rope::SizeOf(const NodePtr& node) {
+  return (node == nullptr ? 0 : node->size);
+}
+
+Rope::NodePtr Rope::MakeLeaf(std::shared_ptr<const String> text,
+                             size_t offset, size_t size) {
+  auto node = std::make_shared<Node>();
+  node->text = std::move(text);
+  node->offset = offset;
+  node->size = size;
+  return node;
+}
+
+Rope::NodePtr Rope::MakeConcat(NodePtr left, NodePtr right) {
+  auto node = std::make_shared<Node>();
+  node->size = left->size + right->size;
+  node->height = std::max(left->height, right->height) + 1;
+  node->left = std::move(left);
+  node->right = std::move(right);
+  return node;
+}
+
+// Concatenation node of two AVL trees whose heights differ by at most 2,
+// rotated back into balance.
+Rope::NodePtr Rope::Balance(NodePtr left, NodePtr right) {
+  if (Height(left) > Height(right) + 1) {
+    if (Height(left->left) >= Height(left->right)) {
+      return MakeConcat(left->left, MakeConcat(left->right, std::move(right)));
+    }
+    return MakeConcat(MakeConcat(left->left, left->right->left),
+                      MakeConcat(left->right->right, std::move(right)));
+  }
+  if (Height(right) > Height(left) + 1) {
+    if (Height(right->right) >= Height(right->left)) {
+      return MakeConcat(MakeConcat(std::move(left), right->left), right->right);
+    }
+    return MakeConcat(MakeConcat(std::move(left), right->left->left),
+                      MakeConcat(right->left->right, right->right));
+  }
+  return MakeConcat(std::move(left), std::move(right));
+}
+
+// AVL join: walks down the spine of the taller tree to a subtree of the
+// other's height, so it is O(difference of heights).
+Rope::NodePtr Rope::Join(NodePtr left, NodePtr right) {
+  if (left == nullptr) {
+    return right;
+  }
+  if (right == nullptr) {
+    return left;
+  }
+  if (Height(left) > Height(right) + 1) {
+    return Balance(left->left, Join(left->right, std::move(right)));
+  }
+  if (Height(right) > Height(left) + 1) {
+    return Balance(Join(std::move(left), right->left), right->right);
+  }
+  return MakeConcat(std::move(left), std::move(right));
+}
+
+Rope::NodePtr Rope::Slice(const NodePtr& node, size_t pos, size_t count) {
+  if (count == 0) {
+    return nullptr;
+  }
+  if (pos == 0 && count == node->size) {
+    return node;
+  }
+  if (node->left == nullptr) {
+    return MakeLeaf(node->text, node->offset + pos, count);
+  }
+  size_t left_size = node->left->size;
+  if (pos + count <= left_size) {
+    return Slice(node->left, pos, count);
+  }
+  if (pos >= left_size) {
+    return Slice(node->right, pos - left_size, count);
+  }
+  return Join(Slice(node->left, pos, left_size - pos),
+              Slice(node->right, 0, pos + count - left_size));
+}
+
+/////////////////////////////////////Rope///////////////////////////////////////
+Rope::Rope() = default;
+
+Rope::Rope(StringView view) { *this += view; }
+
+Rope::Rope(const char* str) : Rope(StringView(str)) {}
+
+Rope::Rope(String&& str) { Append(std::move(str)); }
+
+void Rope::FlushTail() {
+  if (!tail_.Empty()) {
+    size_t size = tail_.Size();
+    auto text = std::make_shared<const String>(std::move(tail_));
+    root_ = Join(std::move(root_), MakeLeaf(std::move(text), 0, size));
+    tail_ = String();
+  }
+}
+
+Rope& Rope::operator+=(StringView view) {
+  if (tail_.Size() + view.Size() > kChunkSize) {
+    FlushTail();
+  }
+  if (view.Size() > kChunkSize) {
+    return Append(String(view));
+  }
+  tail_.Append(view.Data(), view.Size());
+  return *this;
+}
+
+Rope& Rope::Append(String&& str) {
+  if (str.Size() <= kChunkSize) {
+    return *this += StringView(str);
+  }
+  FlushTail();
+  size_t size = str.Size();
+  auto text = std::make_shared<const String>(std::move(str));
+  root_ = Join(std::move(root_), MakeLeaf(std::move(text), 0, size));
+  return *this;
+}
+
+Rope& Rope::operator+=(const Rope& other) {
+  if (this == &other) {
+    Rope copy(other);
+    return *this += copy;
+  }
+  if (other.root_ == nullptr) {
+    return *this += StringView(other.tail_);
+  }
+  FlushTail();
+  root_ = Join(std::move(root_), other.root_);
+  tail_ = other.tail_;
+  return *this;
+}
+
+char Rope::operator[](size_t index) const {
+  size_t tree_size = SizeOf(root_);
+  if (index >= tree_size) {
+    return tail_[index - tree_size];
+  }
+  const Node* node = root_.get();
+  while (node->left != nullptr) {
+    if (index < node->left->size) {
+      node = node->left.get();
+    } else {
+      index -= node->left->size;
+      node = node->right.get();
+    }
+  }
+  return (*node->text)[node->offset + index];
+}
+
+bool Rope::Empty() const { return Size() == 0; }
+
+size_t Rope::Size() const { return SizeOf(root_) + tail_.Size(); }
+
+Rope Rope::Substr(size_t pos, size_t count) const {
+  size_t size = Size();
+  if (pos > size) {
+    pos = size;
+  }
+  if (count > size - pos) {
+    count = size - pos;
+  }
+  Rope res;
+  size_t tree_size = SizeOf(root_);
+  if (pos < tree_size) {
+    size_t tree_count = std::min(count, tree_size - pos);
+    res.root_ = Slice(root_, pos, tree_count);
+    pos += tree_count;
+    count -= tree_count;
+  }
+  if (count != 0) {
+    res.tail_.Append(tail_.Data() + pos - tree_size, count);
+  }
+  return res;
+}
+
+Rope::ChunkRange Rope::Chunks() const { return ChunkRange(*this); }
+
+String Rope::Flatten() const {
+  String res;
+  res.Reserve(Size());
+  for (StringView chunk : Chunks()) {
+    res.Append(chunk.Data(), chunk.Size());
+  }
+  return res;
+}
+
+Rope operator+(const Rope& first, const Rope& second) {
+  Rope res(first);
+  res += second;
+  return res;
+}
+
+Rope operator+(Rope&& first, const Rope& second) {
+  first += second;
+  return std::move(first);
+}
+
+std::ostream& operator<<(std::ostream& out, const Rope& rope) {
+  for (StringView chunk : rope.Chunks()) {
+    out << chunk;
+  }
+  return out;
+}
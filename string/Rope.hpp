@@ -0,0 +1,127 @@
+#pragma once
+
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+#include "String.hpp"
+
+// Cord built from String chunks for assembling very large texts. The
+// chunks hang off an immutable AVL-balanced tree that copies of a Rope
+// share; small appends go into a tail buffer that is moved into the tree
+// as a chunk once it holds kChunkSize characters.
+//
+// Concatenation and Substr are O(log n) and never copy existing chunks,
+// indexing is O(log n), and Chunks() walks the text without flattening it.
+class Rope {
+ private:
+  struct Node;
+
+ public:
+  static const size_t kChunkSize = 4096;
+
+  class ChunkIterator {
+   public:
+    using value_type = StringView;
+    using reference = StringView;
+    using difference_type = ptrdiff_t;
+    using iterator_category = std::input_iterator_tag;
+
+    // Equal to the end, as ranges algorithms need.
+    ChunkIterator();
+
+    StringView operator*() const;
+
+    ChunkIterator& operator++();
+
+    void operator++(int);
+
+    bool operator==(std::default_sentinel_t) const;
+
+   private:
+    friend class Rope;
+
+    explicit ChunkIterator(const Rope& rope);
+
+    void Next();
+
+    const Rope* rope_;
+    std::vector<const Node*> stack_;
+    StringView chunk_;
+    bool in_tail_;
+    bool done_;
+  };
+
+  class ChunkRange {
+   public:
+    [[nodiscard]] ChunkIterator begin() const;
+
+    [[nodiscard]] std::default_sentinel_t end() const;
+
+   private:
+    friend class Rope;
+
+    explicit ChunkRange(const Rope& rope);
+
+    const Rope* rope_;
+  };
+
+  Rope();
+
+  Rope(StringView view);
+
+  // Keeps Rope("text") from being ambiguous between the two overloads
+  // around it.
+  Rope(const char* str);
+
+  // Adopts the buffer of str as a chunk without copying it.
+  Rope(String&& str);
+
+  Rope& operator+=(const Rope& other);
+
+  Rope& operator+=(StringView view);
+
+  Rope& Append(String&& str);
+
+  char operator[](size_t index) const;
+
+  [[nodiscard]] bool Empty() const;
+
+  [[nodiscard]] size_t Size() const;
+
+  [[nodiscard]] Rope Substr(size_t pos, size_t count) const;
+
+  [[nodiscard]] ChunkRange Chunks() const;
+
+  [[nodiscard]] String Flatten() const;
+
+ private:
+  using NodePtr = std::shared_ptr<const Node>;
+
+  static NodePtr MakeLeaf(std::shared_ptr<const String> text, size_t offset,
+                          size_t size);
+
+  static NodePtr MakeConcat(NodePtr left, NodePtr right);
+
+  static NodePtr Balance(NodePtr left, NodePtr right);
+
+  static NodePtr Join(NodePtr left, NodePtr right);
+
+  static NodePtr Slice(const NodePtr& node, size_t pos, size_t count);
+
+  static int Height(const NodePtr& node);
+
+  static size_t SizeOf(const NodePtr& node);
+
+  void FlushTail();
+
+  NodePtr root_;
+  String tail_;
+};
+
+Rope operator+(const Rope& first, const Rope& second);
+
+Rope operator+(Rope&& first, const Rope& second);
+
+std::ostream& operator<<(std::ostream& out, const Rope& rope);
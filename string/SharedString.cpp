@@ -0,0 +1,123 @@
+#include "SharedString.hpp"
+
+SharedString::Buffer::Buffer(String value)
+    : refs(1), str(std::move(value)) {}
+
+SharedString::SharedString() : buffer_(nullptr) {}
+
+SharedString::SharedString(String str) : buffer_(new Buffer(std::move(str))) {}
+
+SharedString::SharedString(StringView view)
+    : buffer_(new Buffer(String(view))) {}
+
+SharedString::SharedString(const SharedString& other)
+    : buffer_(other.buffer_) {
+  if (buffer_ == nullptr) {
+    return;
+  }
+  if (buffer_->unshareable) {
+    buffer_ = new Buffer(buffer_->str);
+  } else {
+    buffer_->refs.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+SharedString& SharedString::operator=(const SharedString& other) {
+  if (buffer_ != other.buffer_) {
+    SharedString copy(other);
+    std::swap(buffer_, copy.buffer_);
+  }
+  return *this;
+}
+
+SharedString::SharedString(SharedString&& other) noexcept
+    : buffer_(other.buffer_) {
+  other.buffer_ = nullptr;
+}
+
+SharedString& SharedString::operator=(SharedString&& other) noexcept {
+  if (this != &other) {
+    Release();
+    buffer_ = other.buffer_;
+    other.buffer_ = nullptr;
+  }
+  return *this;
+}
+
+SharedString::~SharedString() { Release(); }
+
+void SharedString::Release() {
+  if (buffer_ != nullptr &&
+      buffer_->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    delete buffer_;
+  }
+  buffer_ = nullptr;
+}
+
+const String& SharedString::Get() const {
+  static const String kEmpty;
+  return (buffer_ != nullptr ? buffer_->str : kEmpty);
+}
+
+String& SharedString::Mutable() {
+  String& str = Detach();
+  buffer_->unshareable = true;
+  return str;
+}
+
+String& SharedString::Detach() {
+  if (buffer_ == nullptr) {
+    buffer_ = new Buffer(String());
+  } else if (buffer_->refs.load(std::memory_order_acquire) != 1) {
+    Buffer* copy = new Buffer(buffer_->str);
+    Release();
+    buffer_ = copy;
+  }
+  return buffer_->str;
+}
+
+size_t SharedString::UseCount() const {
+  return (buffer_ != nullptr ? buffer_->refs.load(std::memory_order_relaxed)
+                             : 0);
+}
+
+char SharedString::operator[](size_t index) const { return Get()[index]; }
+
+char& SharedString::operator[](size_t index) { return Mutable()[index]; }
+
+bool SharedString::Empty() const { return Get().Empty(); }
+
+size_t SharedString::Size() const { return Get().Size(); }
+
+const char* SharedString::Data() const { return Get().Data(); }
+
+SharedString::operator StringView() const { return Get(); }
+
+size_t SharedString::Hash() const { return Get().Hash(); }
+
+void SharedString::Clear() { Detach().Clear(); }
+
+void SharedString::PushBack(char character) { Detach().PushBack(character); }
+
+void SharedString::Resize(size_t new_size) { Detach().Resize(new_size); }
+
+SharedString& SharedString::operator+=(StringView view) {
+  Detach().Append(view.Data(), view.Size());
+  return *this;
+}
+
+bool operator==(const SharedString& first, const SharedString& second) {
+  return first.Data() == second.Data() || first.Get() == second.Get();
+}
+
+bool operator!=(const SharedString& first, const SharedString& second) {
+  return !(first == second);
+}
+
+bool operator<(const SharedString& first, const SharedString& second) {
+  return first.Get() < second.Get();
+}
+
+std::ostream& operator<<(std::ostream& out, const SharedString& str) {
+  return out << str.Get();
+}
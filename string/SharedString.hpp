@@ -0,0 +1,93 @@
+#pragma once
+
+#include <atomic>
+
+#include "String.hpp"
+
+// Copy-on-write String for payloads fanned out to many consumers. Copies
+// share one reference-counted buffer and cost an atomic increment, so
+// they are safe to hand to other threads; the first mutating call on a
+// copy whose buffer is shared detaches it with a tight copy.
+//
+// Mutable() and the non-const operator[] hand out references that could
+// write to the buffer at any later time, so they mark it unshareable: from
+// then on copies of this SharedString get a buffer of their own.
+class SharedString {
+ public:
+  SharedString();
+
+  explicit SharedString(String str);
+
+  explicit SharedString(StringView view);
+
+  SharedString(const SharedString& other);
+  SharedString& operator=(const SharedString& other);
+
+  SharedString(SharedString&& other) noexcept;
+  SharedString& operator=(SharedString&& other) noexcept;
+
+  ~SharedString();
+
+  [[nodiscard]] const String& Get() const;
+
+  // Detaches the buffer if it is shared and gives full String access. The
+  // buffer is no longer shared with later copies.
+  String& Mutable();
+
+  // Number of SharedStrings sharing this buffer, 0 for an empty one.
+  [[nodiscard]] size_t UseCount() const;
+
+  char operator[](size_t index) const;
+
+  char& operator[](size_t index);
+
+  [[nodiscard]] bool Empty() const;
+
+  [[nodiscard]] size_t Size() const;
+
+  [[nodiscard]] const char* Data() const;
+
+  operator StringView() const;
+
+  [[nodiscard]] size_t Hash() const;
+
+  void Clear();
+
+  void PushBack(char character);
+
+  void Resize(size_t new_size);
+
+  SharedString& operator+=(StringView view);
+
+ private:
+  struct Buffer {
+    explicit Buffer(String value);
+
+    std::atomic<size_t> refs;
+    // Set once a reference into str has been handed out; only the single
+    // owner of the buffer touches it.
+    bool unshareable = false;
+    String str;
+  };
+
+  // Mutable() without marking the buffer unshareable, for the mutators
+  // that do not let a reference escape.
+  String& Detach();
+
+  void Release();
+
+  Buffer* buffer_;
+};
+
+bool operator==(const SharedString& first, const SharedString& second);
+
+bool operator!=(const SharedString& first, const SharedString& second);
+
+bool operator<(const SharedString& first, const SharedString& second);
+
+std::ostream& operator<<(std::ostream& out, const SharedString& str);
+
+template <>
+struct std::hash<SharedString> {
+  size_t operator()(const SharedString& str) const { return str.Hash(); }
+};
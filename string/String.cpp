@@ -1,243 +1,504 @@
 #include "String.hpp"
 
-String::String() {
-  data_ = (char*)calloc(1, sizeof(char));
-  size_ = 0;
-  capacity_ = 1;
+#include "StringStats.hpp"
+
+namespace {
+
+// Longest shortest-round-trip text of a double, as in
+// -2.2250738585072014e-308.
+const size_t kMaxShortestDouble = 24;
+
+}  // namespace
+
+String::String() : size_(0), resource_(nullptr) { Init(0); }
+
+String::String(std::pmr::memory_resource* resource)
+    : size_(0), resource_(resource) {
+  Init(0);
+}
+
+String::String(size_t size, char character,
+               std::pmr::memory_resource* resource)
+    : size_(size), resource_(resource) {
+  Init(size);
+  memset(Storage(), character, size);
 }
 
-String::String(size_t size, char character) {
-  data_ = (char*)calloc(size + 1, sizeof(char));
-  size_ = size;
-  capacity_ = size + 1;
-  memset(data_, character, size);
+String::String(const char* new_data, std::pmr::memory_resource* resource)
+    : size_(strlen(new_data)), resource_(resource) {
+  Init(size_);
+  memcpy(Storage(), new_data, size_);
+  string_stats::OnCopy(size_);
 }
 
-String::String(const char* new_data) {
-  size_ = strlen(new_data);
-  data_ = (char*)calloc(size_ + 1, sizeof(char));
-  data_[size_] = '\0';
-  capacity_ = size_ + 1;
-  memcpy(data_, new_data, size_);
+String::String(StringView view, std::pmr::memory_resource* resource)
+    : size_(view.Size()), resource_(resource) {
+  Init(size_);
+  memcpy(Storage(), view.Data(), size_);
+  string_stats::OnCopy(size_);
 }
 
-String::String(const String& other) {
-  size_ = other.size_;
-  capacity_ = other.capacity_;
-  data_ = (char*)calloc(capacity_, sizeof(char));
-  memcpy(data_, other.data_, capacity_);
+// Copies get a tight capacity and move only the characters, not the
+// unused part of the source's buffer.
+String::String(const String& other)
+    : size_(other.size_), resource_(nullptr) {
+  Init(size_);
+  memcpy(Storage(), other.Data(), size_);
+  string_stats::OnCopy(size_);
+}
+
+String::String(const String& other, std::pmr::memory_resource* resource)
+    : size_(other.size_), resource_(resource) {
+  Init(size_);
+  memcpy(Storage(), other.Data(), size_);
+  string_stats::OnCopy(size_);
 }
 
 String& String::operator=(const String& other) {
   if (this != &other) {
-    free(data_);
-    size_ = other.size_;
-    capacity_ = other.capacity_;
-    data_ = (char*)calloc(capacity_, sizeof(char));
-    memcpy(data_, other.data_, capacity_);
+    String copy(other, resource_);
+    Swap(copy);
+  }
+  return *this;
+}
+
+String::String(String&& other) noexcept
+    : size_(other.size_),
+      capacity_(other.capacity_),
+      resource_(other.resource_) {
+  memcpy(inline_, other.inline_, sizeof(inline_));
+  other.size_ = 0;
+  other.Init(0);
+}
+
+// Like the pmr containers, a string keeps its memory resource on
+// assignment, so a buffer from another resource is copied, not stolen.
+// That copy allocates, so a move across resources can throw.
+String& String::operator=(String&& other) {
+  if (this != &other) {
+    if (resource_ == other.resource_) {
+      String moved(std::move(other));
+      Swap(moved);
+    } else {
+      String copy(other, resource_);
+      Swap(copy);
+    }
   }
   return *this;
 }
 
-String::~String() { free(data_); }
+String::~String() {
+  string_stats::OnRelease(capacity_);
+  if (!IsInline()) {
+    Deallocate(heap_, capacity_ + 1);
+  }
+}
+
+std::pmr::memory_resource* String::GetResource() const { return resource_; }
+
+bool String::IsInline() const { return capacity_ <= kInlineCapacity; }
+
+char* String::Storage() { return IsInline() ? inline_ : heap_; }
+
+// Only the terminator after the first size_ characters is written; the
+// caller fills the characters themselves.
+void String::Init(size_t capacity) {
+  capacity_ = capacity;
+  if (!IsInline()) {
+    heap_ = Allocate(capacity_ + 1);
+  }
+  Storage()[size_] = '\0';
+}
+
+char* String::Allocate(size_t size) {
+  string_stats::OnAllocate(size);
+  if (resource_ == nullptr) {
+    return (char*)malloc(size);
+  }
+  return (char*)resource_->allocate(size, alignof(char));
+}
+
+char* String::Reallocate(char* data, size_t old_size, size_t new_size) {
+  string_stats::OnReallocate(old_size, new_size, size_ + 1);
+  if (resource_ == nullptr) {
+    return (char*)realloc(data, new_size);
+  }
+  char* new_data = (char*)resource_->allocate(new_size, alignof(char));
+  memcpy(new_data, data, size_ + 1);
+  resource_->deallocate(data, old_size, alignof(char));
+  return new_data;
+}
+
+void String::Deallocate(char* data, size_t size) {
+  string_stats::OnDeallocate();
+  if (resource_ == nullptr) {
+    free(data);
+  } else {
+    resource_->deallocate(data, size, alignof(char));
+  }
+}
 
 void String::Clear() {
-  memset(data_, 0, size_);
   size_ = 0;
+  Storage()[0] = '\0';
+}
+
+void String::Grow(size_t min_cap) {
+  if (min_cap <= capacity_) {
+    return;
+  }
+  size_t new_cap = (capacity_ != 0 ? capacity_ : 1);
+  while (new_cap < min_cap) {
+    new_cap *= 2;
+  }
+  Reserve(new_cap);
 }
 
 void String::PushBack(char character) {
-  if (size_ == capacity_ - 1) {
-    if (capacity_ != 1) {
-      Reserve((capacity_ - 1) * 2);
-    } else {
-      Reserve(1);
-    }
+  if (size_ == capacity_) {
+    string_stats::OnPushBackGrowth();
   }
-  data_[size_++] = character;
+  Grow(size_ + 1);
+  char* data = Storage();
+  data[size_++] = character;
+  data[size_] = '\0';
 }
 
 void String::PopBack() {
   if (!Empty()) {
-    data_[--size_] = '\0';
+    Storage()[--size_] = '\0';
   }
 }
 
-void String::Resize(size_t new_size) {
-  Reserve(new_size);
-  if (size_ > new_size) {
-    memset(data_ + new_size, '\0', size_ - new_size);
-  }
-  size_ = new_size;
-}
+void String::Resize(size_t new_size) { Resize(new_size, '\0'); }
 
 void String::Resize(size_t new_size, char character) {
   Reserve(new_size);
-  if (size_ > new_size) {
-    memset(data_ + new_size, '\0', size_ - new_size);
-  } else {
-    memset(data_ + size_, character, new_size - size_);
+  char* data = Storage();
+  if (size_ < new_size) {
+    memset(data + size_, character, new_size - size_);
+    if (character == '\0') {
+      string_stats::OnZero(new_size - size_);
+    }
   }
   size_ = new_size;
+  data[size_] = '\0';
 }
 
 void String::Reserve(size_t new_cap) {
-  if (new_cap > capacity_ - 1) {
-    data_ = (char*)realloc(data_, new_cap + 1);
-    memset(data_ + capacity_, '\0', new_cap - capacity_ + 1);
-    capacity_ = new_cap + 1;
+  if (new_cap <= capacity_) {
+    return;
   }
+  if (new_cap > kInlineCapacity) {
+    if (IsInline()) {
+      char* heap = Allocate(new_cap + 1);
+      memcpy(heap, inline_, size_ + 1);
+      string_stats::OnCopy(size_ + 1);
+      heap_ = heap;
+    } else {
+      heap_ = Reallocate(heap_, capacity_ + 1, new_cap + 1);
+    }
+  }
+  capacity_ = new_cap;
 }
 
 void String::ShrinkToFit() {
-  data_ = (char*)realloc(data_, size_ + 1);
-  capacity_ = size_ + 1;
+  if (capacity_ <= size_) {
+    return;
+  }
+  string_stats::OnRelease(capacity_);
+  if (!IsInline()) {
+    char* heap = heap_;
+    if (size_ <= kInlineCapacity) {
+      memcpy(inline_, heap, size_ + 1);
+      string_stats::OnCopy(size_ + 1);
+      Deallocate(heap, capacity_ + 1);
+    } else {
+      heap_ = Reallocate(heap, capacity_ + 1, size_ + 1);
+    }
+  }
+  capacity_ = size_;
 }
 
-void String::Swap(String& other) {
-  char* other_data = other.data_;
+void String::Swap(String& other) noexcept {
+  char other_storage[sizeof(inline_)];
+  memcpy(other_storage, other.inline_, sizeof(inline_));
+  memcpy(other.inline_, inline_, sizeof(inline_));
+  memcpy(inline_, other_storage, sizeof(inline_));
   size_t other_size = other.size_;
   size_t other_capacity = other.capacity_;
-  other.data_ = data_;
+  std::pmr::memory_resource* other_resource = other.resource_;
   other.size_ = size_;
   other.capacity_ = capacity_;
-  data_ = other_data;
+  other.resource_ = resource_;
   size_ = other_size;
   capacity_ = other_capacity;
+  resource_ = other_resource;
 }
 
 char String::operator[](size_t index) const {
   if (index > size_) {
     index = size_;
   }
-  return data_[index];
+  return Data()[index];
 }
 
-char& String::operator[](size_t index) { return data_[index]; }
+char& String::operator[](size_t index) { return Storage()[index]; }
 
-const char& String::Front() const { return data_[0]; }
+const char& String::Front() const { return Data()[0]; }
 
-char& String::Front() { return data_[0]; }
+char& String::Front() { return Storage()[0]; }
 
-const char& String::Back() const { return data_[size_ - 1]; }
+const char& String::Back() const { return Data()[size_ - 1]; }
 
-char& String::Back() { return data_[size_ - 1]; }
+char& String::Back() { return Storage()[size_ - 1]; }
 
 bool String::Empty() const { return (size_ == 0); }
 
 size_t String::Size() const { return size_; }
 
-size_t String::Capacity() const { return capacity_ - 1; }
+size_t String::Capacity() const { return capacity_; }
+
+const char* String::Data() const { return IsInline() ? inline_ : heap_; }
 
-const char* String::Data() const { return data_; }
+String::operator StringView() const { return {Data(), size_}; }
 
-String& String::operator+=(const String& other) {
-  size_t size = other.Size();
-  for (size_t i = 0; i < size; i++) {
-    PushBack(other[i]);
+size_t String::Hash() const { return StringView(*this).Hash(); }
+
+String& String::Append(const char* data, size_t count) {
+  if (size_ + count > capacity_) {
+    const char* old_data = Data();
+    bool aliased = (data >= old_data && data <= old_data + size_);
+    size_t offset = data - old_data;
+    Grow(size_ + count);
+    if (aliased) {
+      data = Data() + offset;
+    }
   }
+  char* storage = Storage();
+  memcpy(storage + size_, data, count);
+  string_stats::OnCopy(count);
+  size_ += count;
+  storage[size_] = '\0';
+  return *this;
+}
+
+String& String::Append(const String& other) {
+  return Append(other.Data(), other.size_);
+}
+
+String& String::Append(size_t count, char character) {
+  Grow(size_ + count);
+  char* storage = Storage();
+  memset(storage + size_, character, count);
+  size_ += count;
+  storage[size_] = '\0';
   return *this;
 }
 
+String& String::AppendDouble(double value) {
+  return AppendInPlace(kMaxShortestDouble, [value](char* out, size_t count) {
+    return std::to_chars(out, out + count, value).ptr - out;
+  });
+}
+
+String& String::AppendDouble(double value, std::chars_format format,
+                             int precision) {
+  // Sign, point, exponent and precision digits after the point; fixed
+  // notation adds up to 309 digits before it. A negative precision means
+  // the default of 6.
+  size_t digits = (precision < 0 ? 6 : precision);
+  size_t max_count =
+      digits + (format == std::chars_format::fixed ? 311 : 9);
+  return AppendInPlace(max_count, [&](char* out, size_t count) {
+    return std::to_chars(out, out + count, value, format, precision).ptr -
+           out;
+  });
+}
+
+String& String::operator+=(const String& other) { return Append(other); }
+
 String& String::operator*=(int n) {
-  size_t size = size_;
-  if (n == 0) {
+  if (n <= 0) {
     Clear();
-  } else {
-    while (--n != 0) {
-      for (size_t i = 0; i < size; i++) {
-        PushBack(data_[i]);
-      }
-    }
+    return *this;
   }
-  return *this;
+  size_t total = size_ * n;
+  Grow(total);
+  while (size_ != 0 && size_ * 2 <= total) {
+    Append(Data(), size_);
+  }
+  return Append(Data(), total - size_);
 }
 
 String operator+(const String& first, const String& second) {
   String res(first);
-  res += second;
+  res.Append(second);
   return res;
 }
 
+String operator+(String&& first, const String& second) {
+  first.Append(second);
+  return std::move(first);
+}
+
 String operator*(const String& str, int n) {
   String res(str);
   res *= n;
   return res;
 }
 
+String operator*(String&& str, int n) {
+  str *= n;
+  return std::move(str);
+}
+
+size_t String::Find(StringView needle, size_t pos) const {
+  return StringView(*this).Find(needle, pos);
+}
+
+size_t String::RFind(StringView needle, size_t pos) const {
+  return StringView(*this).RFind(needle, pos);
+}
+
+bool String::Contains(StringView needle) const {
+  return StringView(*this).Contains(needle);
+}
+
+size_t String::Count(StringView needle) const {
+  return StringView(*this).Count(needle);
+}
+
+bool String::StartsWith(StringView prefix) const {
+  return StringView(*this).StartsWith(prefix);
+}
+
+bool String::EndsWith(StringView suffix) const {
+  return StringView(*this).EndsWith(suffix);
+}
+
+bool String::ParseDouble(double& value) const {
+  return StringView(*this).ParseDouble(value);
+}
+
 std::vector<String> String::Split(const String& delim) const {
+  std::vector<StringView> views = SplitView(delim);
   std::vector<String> strings;
-  String str;
-  for (size_t i = 0; i <= size_; i++) {
-    bool split = true;
-    if (i + delim.Size() - 1 < size_) {
-      for (size_t j = 0; j < delim.Size(); j++) {
-        if (delim[j] != data_[i + j]) {
-          split = false;
-        }
-      }
-    } else {
-      split = false;
-    }
-    if (split) {
-      strings.push_back(str);
-      str.Clear();
-      i += delim.Size() - 1;
-    } else if (i != size_) {
-      str.PushBack(data_[i]);
-    } else {
-      strings.push_back(str);
-    }
+  strings.reserve(views.size());
+  for (StringView view : views) {
+    strings.emplace_back(view);
   }
   return strings;
 }
 
+std::pmr::vector<String> String::Split(
+    StringView delim, std::pmr::memory_resource* resource) const {
+  std::pmr::vector<String> strings(resource);
+  for (StringView view : SplitLazy(delim)) {
+    strings.emplace_back(view, resource);
+  }
+  return strings;
+}
+
+std::vector<StringView> String::SplitView(StringView delim) const {
+  return StringView(*this).Split(delim);
+}
+
+SplitRange String::SplitLazy(StringView delim, size_t max_split) const {
+  return StringView(*this).SplitLazy(delim, max_split);
+}
+
 String String::Join(const std::vector<String>& strings) const {
-  String res;
-  if (!strings.empty()) {
-    res += strings[0];
+  return Join(std::ranges::ref_view(strings));
+}
+
+std::istream& String::AppendLine(std::istream& in, char delim) {
+  if (capacity_ < kInlineCapacity) {
+    Reserve(kInlineCapacity);
   }
-  for (size_t i = 1; i < strings.size(); i++) {
-    res += *this + strings[i];
+  while (true) {
+    if (size_ == capacity_) {
+      Grow(size_ + 1);
+    }
+    // istream::getline copies straight out of the stream buffer and stops
+    // with failbit only when our free space runs out before the delimiter.
+    size_t space = capacity_ - size_;
+    in.getline(Storage() + size_, space + 1, delim);
+    size_t extracted = in.gcount();
+    if (!in.fail() && !in.eof()) {
+      size_ += extracted - 1;
+      return in;
+    }
+    size_ += extracted;
+    if (in.eof() || extracted != space) {
+      return in;
+    }
+    in.clear(in.rdstate() & ~std::ios_base::failbit);
   }
-  return res;
+}
+
+std::istream& String::ReadLine(std::istream& in, char delim) {
+  Clear();
+  return AppendLine(in, delim);
+}
+
+std::istream& String::ReadAll(std::istream& in) {
+  Clear();
+  std::istream::sentry sentry(in, true);
+  if (!sentry) {
+    return in;
+  }
+  std::streambuf* buffer = in.rdbuf();
+  while (true) {
+    Grow(size_ + kInlineCapacity + 1);
+    size_t space = capacity_ - size_;
+    size_t read = buffer->sgetn(Storage() + size_, space);
+    size_ += read;
+    if (read < space) {
+      break;
+    }
+  }
+  Storage()[size_] = '\0';
+  in.setstate(std::ios_base::eofbit);
+  return in;
 }
 
 std::ostream& operator<<(std::ostream& out, const String& str) {
-  for (int i = 0; i < str.Size(); i++) {
-    out << str[i];
+  std::ostream::sentry sentry(out);
+  if (sentry) {
+    std::streamsize size = str.Size();
+    if (out.rdbuf()->sputn(str.Data(), size) != size) {
+      out.setstate(std::ios_base::badbit);
+    }
   }
   return out;
 }
 
 std::istream& operator>>(std::istream& in, String& str) {
-  char input;
-  while (in.get(input) && input != '\n') {
-    str.PushBack(input);
-  }
-  return in;
+  return str.AppendLine(in, '\n');
 }
 
 bool operator<(const String& first, const String& second) {
-  return strcmp(first.Data(), second.Data()) < 0;
+  return StringView(first).Compare(second) < 0;
 }
 
 bool operator>(const String& first, const String& second) {
-  return strcmp(first.Data(), second.Data()) > 0;
+  return StringView(first).Compare(second) > 0;
 }
 
 bool operator<=(const String& first, const String& second) {
-  return strcmp(first.Data(), second.Data()) <= 0;
+  return StringView(first).Compare(second) <= 0;
 }
 
 bool operator>=(const String& first, const String& second) {
-  return strcmp(first.Data(), second.Data()) >= 0;
+  return StringView(first).Compare(second) >= 0;
 }
 
 bool operator==(const String& first, const String& second) {
-  return strcmp(first.Data(), second.Data()) == 0;
+  return first.Size() == second.Size() &&
+         memcmp(first.Data(), second.Data(), first.Size()) == 0;
 }
 
 bool operator!=(const String& first, const String& second) {
-  return strcmp(first.Data(), second.Data()) != 0;
+  return !(first == second);
 }
@@ -2,20 +2,44 @@
 
 #include <string.h>
 
+#include <charconv>
+#include <concepts>
 #include <iostream>
+#include <limits>
+#include <memory_resource>
+#include <ranges>
+#include <utility>
 #include <vector>
 
+#include "StringView.hpp"
+
 class String {
  public:
+  static const size_t kNpos = StringView::kNpos;
+
+  // Every constructor can take a memory resource for the heap buffer;
+  // nullptr (the default) means calloc/realloc/free. The resource must
+  // outlive the string. Copies and Split results go to the C heap unless
+  // a resource is passed explicitly.
   String();
 
-  String(size_t size, char character);
+  explicit String(std::pmr::memory_resource* resource);
+
+  String(size_t size, char character,
+         std::pmr::memory_resource* resource = nullptr);
 
-  String(const char* new_data);
+  String(const char* new_data, std::pmr::memory_resource* resource = nullptr);
+
+  explicit String(StringView view,
+                  std::pmr::memory_resource* resource = nullptr);
 
   String(const String& other);
+  String(const String& other, std::pmr::memory_resource* resource);
   String& operator=(const String& other);
 
+  String(String&& other) noexcept;
+  String& operator=(String&& other);
+
   ~String();
 
   void Clear();
@@ -28,11 +52,19 @@ class String {
 
   void Resize(size_t new_size, char character);
 
+  // Like C++23 std::string::resize_and_overwrite: makes room for count
+  // characters without initializing them and calls op(data, count), which
+  // fills the buffer and returns the new size (at most count). Characters
+  // before the old size are kept.
+  template <typename Operation>
+  void ResizeAndOverwrite(size_t count, Operation op);
+
   void Reserve(size_t new_cap);
 
   void ShrinkToFit();
 
-  void Swap(String& other);
+  // Exchanges the memory resources together with the buffers.
+  void Swap(String& other) noexcept;
 
   char operator[](size_t index) const;
 
@@ -54,28 +86,194 @@ class String {
 
   [[nodiscard]] const char* Data() const;
 
+  [[nodiscard]] std::pmr::memory_resource* GetResource() const;
+
+  operator StringView() const;
+
+  [[nodiscard]] size_t Hash() const;
+
+  // Appends grow the capacity along the same doubling sequence as
+  // PushBack, but reserve once and copy the whole block at a time.
+  String& Append(const char* data, size_t count);
+
+  String& Append(const String& other);
+
+  String& Append(size_t count, char character);
+
+  // Grows like Append so that max_count more characters fit and calls
+  // op(end, max_count), which writes at most max_count characters after
+  // the current end and returns how many it wrote.
+  template <typename Operation>
+  String& AppendInPlace(size_t max_count, Operation op);
+
+  // Decimal text of value, formatted with std::to_chars straight into the
+  // buffer.
+  template <std::integral Int>
+  String& AppendInt(Int value);
+
+  // Shortest text that parses back to exactly value.
+  String& AppendDouble(double value);
+
+  // std::to_chars with an explicit format and precision.
+  String& AppendDouble(double value, std::chars_format format,
+                       int precision);
+
   String& operator+=(const String& other);
 
   String& operator*=(int n);
 
+  [[nodiscard]] size_t Find(StringView needle, size_t pos = 0) const;
+
+  [[nodiscard]] size_t RFind(StringView needle, size_t pos = kNpos) const;
+
+  [[nodiscard]] bool Contains(StringView needle) const;
+
+  [[nodiscard]] size_t Count(StringView needle) const;
+
+  [[nodiscard]] bool StartsWith(StringView prefix) const;
+
+  [[nodiscard]] bool EndsWith(StringView suffix) const;
+
+  // See StringView::ParseInt and ParseDouble.
+  template <std::integral Int>
+  [[nodiscard]] bool ParseInt(Int& value, int base = 10) const;
+
+  [[nodiscard]] bool ParseDouble(double& value) const;
+
+  // Replaces the contents with the next line of in (the delimiter is
+  // consumed but not stored), reusing the current capacity.
+  std::istream& ReadLine(std::istream& in, char delim = '\n');
+
+  // Replaces the contents with everything left in in.
+  std::istream& ReadAll(std::istream& in);
+
   [[nodiscard]] std::vector<String> Split(const String& delim = " ") const;
 
+  // Both the vector and every token are allocated from resource.
+  [[nodiscard]] std::pmr::vector<String> Split(
+      StringView delim, std::pmr::memory_resource* resource) const;
+
+  // Same tokens as Split, but as views into this string's buffer: nothing
+  // is copied, and the views are invalidated by any change to the string.
+  [[nodiscard]] std::vector<StringView> SplitView(
+      StringView delim = " ") const;
+
+  [[nodiscard]] SplitRange SplitLazy(StringView delim = " ",
+                                     size_t max_split = -1) const;
+
   [[nodiscard]] String Join(const std::vector<String>& strings) const;
 
+  // Accepts any forward range of String, StringView or const char*. The
+  // total length is summed first, so the result is allocated once.
+  template <std::ranges::forward_range Range>
+    requires std::convertible_to<std::ranges::range_reference_t<Range>,
+                                 StringView>
+  [[nodiscard]] String Join(Range&& strings) const;
+
  private:
+  // Strings whose capacity fits here live inside the object and never
+  // touch the heap. Capacity() still follows the doubling scheme, the
+  // inline buffer only decides where the characters are stored.
+  static const size_t kInlineCapacity = 15;
+
+  [[nodiscard]] bool IsInline() const;
+
+  char* Storage();
+
+  void Init(size_t capacity);
+
+  char* Allocate(size_t size);
+
+  char* Reallocate(char* data, size_t old_size, size_t new_size);
+
+  void Deallocate(char* data, size_t size);
+
+  void Grow(size_t min_cap);
+
+  std::istream& AppendLine(std::istream& in, char delim);
+
+  friend std::istream& operator>>(std::istream& in, String& str);
+
   size_t size_;
   size_t capacity_;
-  char* data_;
+  std::pmr::memory_resource* resource_;
+  union {
+    char* heap_;
+    char inline_[kInlineCapacity + 1];
+  };
 };
 
+template <typename Operation>
+void String::ResizeAndOverwrite(size_t count, Operation op) {
+  Reserve(count);
+  char* data = Storage();
+  size_ = op(data, count);
+  data[size_] = '\0';
+}
+
+template <typename Operation>
+String& String::AppendInPlace(size_t max_count, Operation op) {
+  Grow(size_ + max_count);
+  char* data = Storage();
+  size_ += op(data + size_, max_count);
+  data[size_] = '\0';
+  return *this;
+}
+
+template <std::integral Int>
+String& String::AppendInt(Int value) {
+  // The digits, one more than digits10 does not count, and the sign.
+  const size_t kMaxChars = std::numeric_limits<Int>::digits10 + 2;
+  return AppendInPlace(kMaxChars, [value](char* out, size_t max_count) {
+    return std::to_chars(out, out + max_count, value).ptr - out;
+  });
+}
+
+template <std::integral Int>
+bool String::ParseInt(Int& value, int base) const {
+  return StringView(*this).ParseInt(value, base);
+}
+
+template <std::ranges::forward_range Range>
+  requires std::convertible_to<std::ranges::range_reference_t<Range>,
+                               StringView>
+String String::Join(Range&& strings) const {
+  size_t count = 0;
+  size_t total = 0;
+  for (StringView str : strings) {
+    total += str.Size();
+    ++count;
+  }
+  if (count != 0) {
+    total += (count - 1) * size_;
+  }
+  String res;
+  res.Reserve(total);
+  bool first = true;
+  for (StringView str : strings) {
+    if (!first) {
+      res.Append(Data(), size_);
+    }
+    res.Append(str.Data(), str.Size());
+    first = false;
+  }
+  return res;
+}
+
 std::ostream& operator<<(std::ostream& out, const String& str);
 
 std::istream& operator>>(std::istream& in, String& str);
 
 String operator+(const String& first, const String& second);
 
+// Reuses the buffer of the temporary left operand, so a chain like
+// a + b + c + d grows a single string instead of copying at every step.
+String operator+(String&& first, const String& second);
+
 String operator*(const String& str, int n);
 
+String operator*(String&& str, int n);
+
 bool operator<(const String& first, const String& second);
 
 bool operator>(const String& first, const String& second);
@@ -87,3 +285,8 @@ bool operator>=(const String& first, const String& second);
 bool operator==(const String& first, const String& second);
 
 bool operator!=(const String& first, const String& second);
+
+template <>
+struct std::hash<String> {
+  size_t operator()(const String& str) const { return str.Hash(); }
+};
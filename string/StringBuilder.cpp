@@ -0,0 +1,17 @@
+#include "StringBuilder.hpp"
+
+StringBuilder::StringBuilder() = default;
+
+StringBuilder::StringBuilder(size_t capacity) { str_.Reserve(capacity); }
+
+size_t StringBuilder::Size() const { return str_.Size(); }
+
+StringView StringBuilder::View() const { return str_; }
+
+void StringBuilder::Clear() { str_.Clear(); }
+
+String StringBuilder::Release() {
+  String res(std::move(str_));
+  str_ = String();
+  return res;
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <charconv>
+#include <concepts>
+#include <limits>
+
+#include "String.hpp"
+
+// Piece accepted by StringBuilder and Concat: text (anything convertible
+// to StringView), a single char, an integer or a floating-point number.
+template <typename Piece>
+concept StringPiece =
+    std::convertible_to<const Piece&, StringView> ||
+    std::same_as<Piece, char> ||
+    (std::integral<Piece> && !std::same_as<Piece, bool>) ||
+    std::floating_point<Piece>;
+
+namespace string_builder {
+
+// Upper bound on the characters piece formats to.
+template <StringPiece Piece>
+size_t MaxSize(const Piece& piece) {
+  if constexpr (std::convertible_to<const Piece&, StringView>) {
+    return StringView(piece).Size();
+  } else if constexpr (std::same_as<Piece, char>) {
+    return 1;
+  } else if constexpr (std::integral<Piece>) {
+    return std::numeric_limits<Piece>::digits10 + 2;
+  } else {
+    // Shortest round-trip text, e.g. -2.2250738585072014e-308.
+    return std::numeric_limits<Piece>::max_digits10 + 8;
+  }
+}
+
+// Writes piece at out and returns the end of what was written.
+template <StringPiece Piece>
+char* Write(char* out, const Piece& piece) {
+  if constexpr (std::convertible_to<const Piece&, StringView>) {
+    StringView view(piece);
+    memcpy(out, view.Data(), view.Size());
+    return out + view.Size();
+  } else if constexpr (std::same_as<Piece, char>) {
+    *out = piece;
+    return out + 1;
+  } else {
+    return std::to_chars(out, out + MaxSize(piece), piece).ptr;
+  }
+}
+
+}  // namespace string_builder
+
+// Builds a String from pieces. Every Append adds up the sizes of all its
+// pieces first, grows the buffer once and then formats the pieces in
+// place, so StringBuilder().Append("Point(", x, ", ", y, ")") allocates
+// at most once and creates no temporaries.
+class StringBuilder {
+ public:
+  StringBuilder();
+
+  // Reserves room for capacity characters.
+  explicit StringBuilder(size_t capacity);
+
+  template <StringPiece... Pieces>
+  StringBuilder& Append(const Pieces&... pieces);
+
+  template <StringPiece Piece>
+  StringBuilder& operator<<(const Piece& piece);
+
+  [[nodiscard]] size_t Size() const;
+
+  [[nodiscard]] StringView View() const;
+
+  void Clear();
+
+  // Moves the built string out and leaves the builder empty.
+  [[nodiscard]] String Release();
+
+ private:
+  String str_;
+};
+
+template <StringPiece... Pieces>
+StringBuilder& StringBuilder::Append(const Pieces&... pieces) {
+  size_t max_count = (string_builder::MaxSize(pieces) + ... + 0);
+  str_.AppendInPlace(max_count, [&](char* out, size_t /*count*/) {
+    char* end = out;
+    ((end = string_builder::Write(end, pieces)), ...);
+    return end - out;
+  });
+  return *this;
+}
+
+template <StringPiece Piece>
+StringBuilder& StringBuilder::operator<<(const Piece& piece) {
+  return Append(piece);
+}
+
+// Concat("id=", 42, ' ', 0.5) == "id=42 0.5", built with one allocation.
+template <StringPiece... Pieces>
+[[nodiscard]] String Concat(const Pieces&... pieces) {
+  return StringBuilder().Append(pieces...).Release();
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+#include <type_traits>
+
+namespace string_hash {
+
+inline constexpr uint64_t kSecret[4] = {
+    0x2d358dccaa6c78a5ull, 0x8bb84b93962eacc9ull, 0x4b33a62ed433d4a3ull,
+    0x4d5a2da51de1aa47ull};
+
+constexpr void Multiply(uint64_t* a, uint64_t* b) {
+  __uint128_t product = *a;
+  product *= *b;
+  *a = (uint64_t)product;
+  *b = (uint64_t)(product >> 64);
+}
+
+constexpr uint64_t Mix(uint64_t a, uint64_t b) {
+  Multiply(&a, &b);
+  return a ^ b;
+}
+
+// Little-endian load of count bytes. memcpy is not allowed in constant
+// expressions, so those assemble the value byte by byte.
+constexpr uint64_t Read(const char* p, size_t count) {
+  if (std::is_constant_evaluated()) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < count; ++i) {
+      value |= (uint64_t)(unsigned char)p[i] << (8 * i);
+    }
+    return value;
+  }
+  if (count == 8) {
+    uint64_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+  }
+  uint32_t value;
+  memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+constexpr uint64_t Read3(const char* p, size_t size) {
+  return ((uint64_t)(unsigned char)p[0] << 16) |
+         ((uint64_t)(unsigned char)p[size >> 1] << 8) |
+         (unsigned char)p[size - 1];
+}
+
+}  // namespace string_hash
+
+// wyhash (final version 4), a fast 64-bit non-cryptographic hash. Reads
+// the input 8 or 16 bytes at a time and mixes with 64x64->128 multiplies.
+// See https://github.com/wangyi-fudan/wyhash (public domain). Defined here
+// so that FixedString can hash in constant expressions and get the same
+// values as String at run time.
+constexpr uint64_t HashBytes(const char* data, size_t size,
+                             uint64_t seed = 0) {
+  using string_hash::kSecret;
+  using string_hash::Mix;
+  using string_hash::Read;
+  const char* p = data;
+  seed ^= Mix(seed ^ kSecret[0], kSecret[1]);
+  uint64_t a = 0;
+  uint64_t b = 0;
+  if (size <= 16) {
+    if (size >= 4) {
+      a = (Read(p, 4) << 32) | Read(p + ((size >> 3) << 2), 4);
+      b = (Read(p + size - 4, 4) << 32) |
+          Read(p + size - 4 - ((size >> 3) << 2), 4);
+    } else if (size > 0) {
+      a = string_hash::Read3(p, size);
+    }
+  } else {
+    size_t rest = size;
+    if (rest > 48) {
+      uint64_t seed1 = seed;
+      uint64_t seed2 = seed;
+      do {
+        seed = Mix(Read(p, 8) ^ kSecret[1], Read(p + 8, 8) ^ seed);
+        seed1 = Mix(Read(p + 16, 8) ^ kSecret[2], Read(p + 24, 8) ^ seed1);
+        seed2 = Mix(Read(p + 32, 8) ^ kSecret[3], Read(p + 40, 8) ^ seed2);
+        p += 48;
+        rest -= 48;
+      } while (rest > 48);
+      seed ^= seed1 ^ seed2;
+    }
+    while (rest > 16) {
+      seed = Mix(Read(p, 8) ^ kSecret[1], Read(p + 8, 8) ^ seed);
+      p += 16;
+      rest -= 16;
+    }
+    a = Read(p + rest - 16, 8);
+    b = Read(p + rest - 8, 8);
+  }
+  a ^= kSecret[1];
+  b ^= seed;
+  string_hash::Multiply(&a, &b);
+  return Mix(a ^ kSecret[0] ^ size, b ^ kSecret[1]);
+}
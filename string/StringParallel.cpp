@@ -0,0 +1,257 @@
+#include "StringParallel.hpp"
+
+#include <algorithm>
+#include <thread>
+
+namespace {
+
+// Below this many bytes per task starting a thread costs more than the
+// work it takes over.
+const size_t kMinChunk = 1 << 18;
+
+// The same for the number of pieces a ParallelJoin task copies.
+const size_t kMinJoinPieces = 1 << 14;
+
+size_t TaskCount(const IExecutor& executor, size_t work, size_t min_work) {
+  return std::clamp<size_t>(work / min_work, 1, executor.Concurrency());
+}
+
+// Delimiters cut inside one chunk of the source.
+struct ChunkMatches {
+  // Matches found by scanning again from the end of a delimiter that
+  // straddles the chunk edge, before the scan lined up with found.
+  std::vector<size_t> rescanned;
+  // Matches of a greedy scan started at the chunk edge.
+  std::vector<size_t> found;
+  // How many leading entries of found overlap an earlier delimiter.
+  size_t skip = 0;
+  // Where the first token cut inside the chunk begins.
+  size_t token_begin = 0;
+  // Index of that token in the result.
+  size_t first_token = 0;
+};
+
+// Every chunk is scanned concurrently for matches starting inside it. A
+// serial pass then drops the matches that Split would not see because an
+// accepted delimiter from the previous chunk runs into them: the chunk is
+// rescanned from the end of that delimiter until the rescan hits one of
+// the chunk's own matches, after which both scans agree. For delimiters
+// that cannot overlap themselves, such as single characters, nothing is
+// ever rescanned.
+std::vector<ChunkMatches> FindDelimiters(StringView str, StringView delim,
+                                         const IExecutor& executor) {
+  size_t tasks =
+      (delim.Empty() ? 1 : TaskCount(executor, str.Size(), kMinChunk));
+  size_t chunk_size = str.Size() / tasks;
+  auto chunk_end = [&](size_t task) {
+    return (task + 1 == tasks ? str.Size() : (task + 1) * chunk_size);
+  };
+  // Matches may start before the end of the chunk and finish after it.
+  auto window = [&](size_t task) {
+    return str.Substr(0, chunk_end(task) + delim.Size() - 1);
+  };
+
+  std::vector<ChunkMatches> chunks(tasks);
+  if (!delim.Empty()) {
+    executor.Run(tasks, [&](size_t task) {
+      StringView text = window(task);
+      size_t end = chunk_end(task);
+      for (size_t pos = text.Find(delim, task * chunk_size); pos < end;
+           pos = text.Find(delim, pos + delim.Size())) {
+        chunks[task].found.push_back(pos);
+      }
+    });
+  }
+
+  size_t next = 0;
+  size_t tokens = 0;
+  for (size_t task = 0; task < tasks; ++task) {
+    ChunkMatches& chunk = chunks[task];
+    chunk.token_begin = next;
+    chunk.first_token = tokens;
+    if (!chunk.found.empty() && chunk.found.front() < next) {
+      StringView text = window(task);
+      size_t end = chunk_end(task);
+      size_t pos = text.Find(delim, next);
+      while (pos < end) {
+        while (chunk.skip < chunk.found.size() &&
+               chunk.found[chunk.skip] < pos) {
+          ++chunk.skip;
+        }
+        if (chunk.skip < chunk.found.size() &&
+            chunk.found[chunk.skip] == pos) {
+          break;
+        }
+        chunk.rescanned.push_back(pos);
+        pos = text.Find(delim, pos + delim.Size());
+      }
+      if (pos >= end) {
+        chunk.skip = chunk.found.size();
+      }
+    }
+    tokens += chunk.rescanned.size() + chunk.found.size() - chunk.skip;
+    if (!chunk.rescanned.empty()) {
+      next = chunk.rescanned.back() + delim.Size();
+    }
+    if (chunk.skip != chunk.found.size()) {
+      next = chunk.found.back() + delim.Size();
+    }
+  }
+  return chunks;
+}
+
+// Number of tokens: one more than the number of delimiters cut.
+size_t TokenCount(const std::vector<ChunkMatches>& chunks) {
+  const ChunkMatches& last = chunks.back();
+  return last.first_token + last.rescanned.size() + last.found.size() -
+         last.skip + 1;
+}
+
+// Calls emit(index, token) for every token, one task per chunk.
+template <typename Emit>
+void ForEachToken(StringView str, StringView delim,
+                  const std::vector<ChunkMatches>& chunks,
+                  const IExecutor& executor, Emit emit) {
+  executor.Run(chunks.size(), [&](size_t task) {
+    const ChunkMatches& chunk = chunks[task];
+    size_t begin = chunk.token_begin;
+    size_t index = chunk.first_token;
+    auto cut = [&](size_t pos) {
+      emit(index++, str.Substr(begin, pos - begin));
+      begin = pos + delim.Size();
+    };
+    std::ranges::for_each(chunk.rescanned, cut);
+    std::for_each(chunk.found.begin() + chunk.skip, chunk.found.end(), cut);
+    if (task + 1 == chunks.size()) {
+      emit(index, str.Substr(begin, str.Size() - begin));
+    }
+  });
+}
+
+template <typename Piece>
+String JoinPieces(StringView separator, std::span<const Piece> strings,
+                  const IExecutor& executor) {
+  String res;
+  if (strings.empty()) {
+    return res;
+  }
+  size_t tasks = TaskCount(executor, strings.size(), kMinJoinPieces);
+  size_t block_size = strings.size() / tasks;
+  auto block = [&](size_t task) {
+    size_t end = (task + 1 == tasks ? strings.size() : (task + 1) * block_size);
+    return strings.subspan(task * block_size, end - task * block_size);
+  };
+
+  // offsets[task] is where the first piece of the block lands; every piece
+  // is counted together with the separator after it.
+  std::vector<size_t> offsets(tasks + 1, 0);
+  executor.Run(tasks, [&](size_t task) {
+    size_t bytes = 0;
+    for (StringView piece : block(task)) {
+      bytes += piece.Size() + separator.Size();
+    }
+    offsets[task + 1] = bytes;
+  });
+  for (size_t task = 0; task < tasks; ++task) {
+    offsets[task + 1] += offsets[task];
+  }
+  size_t total = offsets[tasks] - separator.Size();
+
+  res.ResizeAndOverwrite(total, [&](char* data, size_t /*count*/) {
+    executor.Run(tasks, [&](size_t task) {
+      // Blocks after the first start with the separator that ends the
+      // previous block.
+      char* out = data + offsets[task] - (task == 0 ? 0 : separator.Size());
+      bool first = (task == 0);
+      for (StringView piece : block(task)) {
+        if (!first) {
+          memcpy(out, separator.Data(), separator.Size());
+          out += separator.Size();
+        }
+        memcpy(out, piece.Data(), piece.Size());
+        out += piece.Size();
+        first = false;
+      }
+    });
+    return total;
+  });
+  return res;
+}
+
+}  // namespace
+
+////////////////////////////////ThreadExecutor//////////////////////////////////
+ThreadExecutor::ThreadExecutor(size_t threads) : threads_(threads) {}
+
+size_t ThreadExecutor::Concurrency() const {
+  if (threads_ != 0) {
+    return threads_;
+  }
+  return std::max<size_t>(std::thread::hardware_concurrency(), 1);
+}
+
+void ThreadExecutor::Run(size_t count,
+                         const std::function<void(size_t)>& task) const {
+  std::vector<std::thread> threads;
+  threads.reserve(count);
+  for (size_t i = 1; i < count; ++i) {
+    threads.emplace_back(task, i);
+  }
+  if (count != 0) {
+    task(0);
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+}
+
+/////////////////////////////////Split / Join///////////////////////////////////
+std::vector<StringView> ParallelSplitView(StringView str, StringView delim,
+                                          size_t threads) {
+  return ParallelSplitView(str, delim, ThreadExecutor(threads));
+}
+
+std::vector<StringView> ParallelSplitView(StringView str, StringView delim,
+                                          const IExecutor& executor) {
+  std::vector<ChunkMatches> chunks = FindDelimiters(str, delim, executor);
+  std::vector<StringView> tokens(TokenCount(chunks));
+  ForEachToken(str, delim, chunks, executor,
+               [&](size_t index, StringView token) { tokens[index] = token; });
+  return tokens;
+}
+
+std::vector<String> ParallelSplit(StringView str, StringView delim,
+                                  size_t threads) {
+  return ParallelSplit(str, delim, ThreadExecutor(threads));
+}
+
+std::vector<String> ParallelSplit(StringView str, StringView delim,
+                                  const IExecutor& executor) {
+  std::vector<ChunkMatches> chunks = FindDelimiters(str, delim, executor);
+  std::vector<String> tokens(TokenCount(chunks));
+  ForEachToken(str, delim, chunks, executor,
+               [&](size_t index, StringView token) {
+                 tokens[index] = String(token);
+               });
+  return tokens;
+}
+
+String ParallelJoin(StringView separator, std::span<const String> strings,
+                    size_t threads) {
+  return ParallelJoin(separator, strings, ThreadExecutor(threads));
+}
+
+String ParallelJoin(StringView separator, std::span<const String> strings,
+                    const IExecutor& executor) {
+  return JoinPieces(separator, strings, executor);
+}
+
+String ParallelJoin(StringView separator, std::span<const StringView> strings,
+                    size_t threads) {
+  return ParallelJoin(separator, strings, ThreadExecutor(threads));
+}
+
+String ParallelJoin(StringView separator, std::span<const StringView> strings,
+                    const IExecutor& executor) {
+  return JoinPieces(separator, strings, executor);
+}
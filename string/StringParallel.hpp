@@ -0,0 +1,77 @@
+#pragma once
+
+#include <functional>
+#include <span>
+#include <vector>
+
+#include "String.hpp"
+
+// Runs batches of independent tasks for the parallel algorithms below.
+class IExecutor {
+ public:
+  virtual ~IExecutor() = default;
+
+  // How many tasks are worth running at the same time.
+  [[nodiscard]] virtual size_t Concurrency() const = 0;
+
+  // Runs task(0), ..., task(count - 1), possibly concurrently, and returns
+  // once all of them have finished.
+  virtual void Run(size_t count,
+                   const std::function<void(size_t)>& task) const = 0;
+};
+
+// Starts a std::thread for every task but the first, which runs on the
+// calling thread.
+class ThreadExecutor : public IExecutor {
+ public:
+  // 0 means std::thread::hardware_concurrency().
+  explicit ThreadExecutor(size_t threads = 0);
+
+  [[nodiscard]] size_t Concurrency() const override;
+
+  void Run(size_t count,
+           const std::function<void(size_t)>& task) const override;
+
+ private:
+  size_t threads_;
+};
+
+// Same tokens as String::Split / SplitView. The source is cut into one
+// chunk per task, every chunk is searched for delimiters concurrently, and
+// matches that a straddling delimiter makes invalid are dropped while the
+// chunks are stitched together. Inputs below a few hundred kilobytes are
+// split serially.
+[[nodiscard]] std::vector<StringView> ParallelSplitView(StringView str,
+                                                        StringView delim,
+                                                        size_t threads = 0);
+
+[[nodiscard]] std::vector<StringView> ParallelSplitView(
+    StringView str, StringView delim, const IExecutor& executor);
+
+// The tokens are also copied out concurrently.
+[[nodiscard]] std::vector<String> ParallelSplit(StringView str,
+                                                StringView delim,
+                                                size_t threads = 0);
+
+[[nodiscard]] std::vector<String> ParallelSplit(StringView str,
+                                                StringView delim,
+                                                const IExecutor& executor);
+
+// Same result as separator.Join(strings). The offsets of all pieces are
+// computed first, then every task copies its share of the pieces into the
+// preallocated result.
+[[nodiscard]] String ParallelJoin(StringView separator,
+                                  std::span<const String> strings,
+                                  size_t threads = 0);
+
+[[nodiscard]] String ParallelJoin(StringView separator,
+                                  std::span<const String> strings,
+                                  const IExecutor& executor);
+
+[[nodiscard]] String ParallelJoin(StringView separator,
+                                  std::span<const StringView> strings,
+                                  size_t threads = 0);
+
+[[nodiscard]] String ParallelJoin(StringView separator,
+                                  std::span<const StringView> strings,
+                                  const IExecutor& executor);
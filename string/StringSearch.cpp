@@ -0,0 +1,312 @@
+#include "StringSearch.hpp"
+
+#include <stddef.h>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+const size_t kNotFound = -1;
+
+const size_t kPrefilterWindow = 256;
+
+// Lets the Two-Way search run over a buffer either as is or reversed, which
+// is how RFindSubstring gets a linear-time backward search.
+template <bool kReversed>
+class Text {
+ public:
+  Text(const char* data, size_t size) : data_(data), size_(size) {}
+
+  unsigned char operator[](size_t index) const {
+    return kReversed ? data_[size_ - 1 - index] : data_[index];
+  }
+
+ private:
+  const char* data_;
+  size_t size_;
+};
+
+// Start of the maximal suffix of the needle under the normal (kTilde =
+// false) or the reversed alphabet order, and the period of that suffix.
+template <bool kTilde, typename T>
+ptrdiff_t MaximalSuffix(const T& needle, ptrdiff_t size, ptrdiff_t* period) {
+  ptrdiff_t suffix = -1;
+  ptrdiff_t j = 0;
+  ptrdiff_t k = 1;
+  *period = 1;
+  while (j + k < size) {
+    unsigned char a = needle[j + k];
+    unsigned char b = needle[suffix + k];
+    if (kTilde ? a > b : a < b) {
+      j += k;
+      k = 1;
+      *period = j - suffix;
+    } else if (a == b) {
+      if (k != *period) {
+        ++k;
+      } else {
+        j += *period;
+        k = 1;
+      }
+    } else {
+      suffix = j;
+      j = suffix + 1;
+      k = *period = 1;
+    }
+  }
+  return suffix;
+}
+
+// Two-Way search (Crochemore-Perrin) combined with a Horspool shift on the
+// last byte of the window, as in glibc: the shift skips most windows, the
+// critical factorization keeps the worst case linear.
+template <typename T>
+size_t TwoWay(const T& haystack, size_t haystack_size, const T& needle,
+              size_t needle_size) {
+  ptrdiff_t period = 0;
+  ptrdiff_t tilde_period = 0;
+  ptrdiff_t suffix = MaximalSuffix<false>(needle, needle_size, &period);
+  ptrdiff_t tilde_suffix =
+      MaximalSuffix<true>(needle, needle_size, &tilde_period);
+  if (tilde_suffix > suffix) {
+    suffix = tilde_suffix;
+    period = tilde_period;
+  }
+  // Length of the left half of the critical factorization.
+  size_t critical = suffix + 1;
+  size_t shifts[256];
+  for (size_t& shift : shifts) {
+    shift = needle_size;
+  }
+  for (size_t i = 0; i < needle_size; i++) {
+    shifts[needle[i]] = needle_size - 1 - i;
+  }
+  bool periodic = true;
+  for (size_t i = 0; i < critical; i++) {
+    if (needle[i] != needle[i + period]) {
+      periodic = false;
+      break;
+    }
+  }
+  size_t j = 0;
+  if (periodic) {
+    // Number of leading needle bytes known to match at the current window.
+    size_t memory = 0;
+    while (j + needle_size <= haystack_size) {
+      size_t shift = shifts[haystack[j + needle_size - 1]];
+      if (shift != 0) {
+        if (memory != 0 && shift < (size_t)period) {
+          shift = needle_size - period;
+        }
+        memory = 0;
+        j += shift;
+        continue;
+      }
+      size_t i = (critical > memory ? critical : memory);
+      while (i < needle_size - 1 && needle[i] == haystack[i + j]) {
+        ++i;
+      }
+      if (i >= needle_size - 1) {
+        i = critical;
+        while (i > memory && needle[i - 1] == haystack[i - 1 + j]) {
+          --i;
+        }
+        if (i <= memory) {
+          return j;
+        }
+        j += period;
+        memory = needle_size - period;
+      } else {
+        j += i - critical + 1;
+        memory = 0;
+      }
+    }
+  } else {
+    size_t right = needle_size - critical;
+    period = (critical > right ? critical : right) + 1;
+    while (j + needle_size <= haystack_size) {
+      size_t shift = shifts[haystack[j + needle_size - 1]];
+      if (shift != 0) {
+        j += shift;
+        continue;
+      }
+      size_t i = critical;
+      while (i < needle_size - 1 && needle[i] == haystack[i + j]) {
+        ++i;
+      }
+      if (i >= needle_size - 1) {
+        i = critical;
+        while (i > 0 && needle[i - 1] == haystack[i - 1 + j]) {
+          --i;
+        }
+        if (i == 0) {
+          return j;
+        }
+        j += period;
+      } else {
+        j += i - critical + 1;
+      }
+    }
+  }
+  return kNotFound;
+}
+
+// memchr on the first byte, memcmp on the rest.
+size_t FindScalar(const char* haystack, size_t haystack_size,
+                  const char* needle, size_t needle_size) {
+  size_t pos = 0;
+  while (pos + needle_size <= haystack_size) {
+    const char* found =
+        (const char*)memchr(haystack + pos, needle[0],
+                            haystack_size - needle_size - pos + 1);
+    if (found == nullptr) {
+      break;
+    }
+    pos = found - haystack;
+    if (memcmp(found + 1, needle + 1, needle_size - 1) == 0) {
+      return pos;
+    }
+    ++pos;
+  }
+  return kNotFound;
+}
+
+using FindShort = size_t (*)(const char*, size_t, const char*, size_t);
+
+#if defined(__x86_64__)
+
+// Candidates are positions whose first and last bytes both match, checked
+// 16 (32) positions at a time; only those reach memcmp.
+// See http://0x80.pl/articles/simd-strfind.html
+size_t FindSse2(const char* haystack, size_t haystack_size, const char* needle,
+                size_t needle_size) {
+  const __m128i first = _mm_set1_epi8(needle[0]);
+  const __m128i last = _mm_set1_epi8(needle[needle_size - 1]);
+  size_t pos = 0;
+  for (; pos + needle_size - 1 + 16 <= haystack_size; pos += 16) {
+    __m128i block_first = _mm_loadu_si128((const __m128i*)(haystack + pos));
+    __m128i block_last = _mm_loadu_si128(
+        (const __m128i*)(haystack + pos + needle_size - 1));
+    unsigned mask = _mm_movemask_epi8(
+        _mm_and_si128(_mm_cmpeq_epi8(first, block_first),
+                      _mm_cmpeq_epi8(last, block_last)));
+    while (mask != 0) {
+      unsigned bit = __builtin_ctz(mask);
+      if (memcmp(haystack + pos + bit + 1, needle + 1, needle_size - 2) == 0) {
+        return pos + bit;
+      }
+      mask &= mask - 1;
+    }
+  }
+  size_t rest = FindScalar(haystack + pos, haystack_size - pos, needle,
+                           needle_size);
+  return (rest == kNotFound ? kNotFound : pos + rest);
+}
+
+__attribute__((target("avx2"))) size_t FindAvx2(const char* haystack,
+                                                size_t haystack_size,
+                                                const char* needle,
+                                                size_t needle_size) {
+  const __m256i first = _mm256_set1_epi8(needle[0]);
+  const __m256i last = _mm256_set1_epi8(needle[needle_size - 1]);
+  size_t pos = 0;
+  for (; pos + needle_size - 1 + 32 <= haystack_size; pos += 32) {
+    __m256i block_first =
+        _mm256_loadu_si256((const __m256i*)(haystack + pos));
+    __m256i block_last = _mm256_loadu_si256(
+        (const __m256i*)(haystack + pos + needle_size - 1));
+    unsigned mask = _mm256_movemask_epi8(
+        _mm256_and_si256(_mm256_cmpeq_epi8(first, block_first),
+                         _mm256_cmpeq_epi8(last, block_last)));
+    while (mask != 0) {
+      unsigned bit = __builtin_ctz(mask);
+      if (memcmp(haystack + pos + bit + 1, needle + 1, needle_size - 2) == 0) {
+        return pos + bit;
+      }
+      mask &= mask - 1;
+    }
+  }
+  size_t rest = FindSse2(haystack + pos, haystack_size - pos, needle,
+                         needle_size);
+  return (rest == kNotFound ? kNotFound : pos + rest);
+}
+
+FindShort SelectFindShort() {
+  __builtin_cpu_init();
+  return (__builtin_cpu_supports("avx2") ? FindAvx2 : FindSse2);
+}
+
+// Resolved on first use, not by a namespace-scope initializer: a Find
+// called from another translation unit's static initializer may run
+// before that one and would see a null pointer.
+FindShort GetFindShort() {
+  static const FindShort kFindShort = SelectFindShort();
+  return kFindShort;
+}
+
+#else
+
+FindShort GetFindShort() {
+  return FindScalar;
+}
+
+#endif
+
+}  // namespace
+
+size_t FindSubstring(const char* haystack, size_t haystack_size,
+                     const char* needle, size_t needle_size) {
+  if (needle_size == 0) {
+    return 0;
+  }
+  if (needle_size > haystack_size) {
+    return kNotFound;
+  }
+  if (needle_size == 1) {
+    const char* found = (const char*)memchr(haystack, needle[0], haystack_size);
+    return (found == nullptr ? kNotFound : found - haystack);
+  }
+  if (needle_size <= kShortNeedle) {
+    return GetFindShort()(haystack, haystack_size, needle, needle_size);
+  }
+  // Two-Way preprocessing costs O(needle_size + 256), which dominates
+  // when the match is near (Split with a long delimiter), so the first
+  // kPrefilterWindow positions are tried with the SIMD filter.
+  size_t positions = haystack_size - needle_size + 1;
+  size_t window = (positions < kPrefilterWindow ? positions : kPrefilterWindow);
+  size_t found = GetFindShort()(haystack, window + needle_size - 1, needle,
+                                needle_size);
+  if (found != kNotFound || window == positions) {
+    return found;
+  }
+  found = TwoWay(Text<false>(haystack + window, haystack_size - window),
+                 haystack_size - window, Text<false>(needle, needle_size),
+                 needle_size);
+  return (found == kNotFound ? kNotFound : window + found);
+}
+
+size_t RFindSubstring(const char* haystack, size_t haystack_size,
+                      const char* needle, size_t needle_size) {
+  if (needle_size == 0) {
+    return haystack_size;
+  }
+  if (needle_size > haystack_size) {
+    return kNotFound;
+  }
+  if (needle_size <= kShortNeedle) {
+    for (size_t pos = haystack_size - needle_size + 1; pos-- > 0;) {
+      if (haystack[pos] == needle[0] &&
+          memcmp(haystack + pos, needle, needle_size) == 0) {
+        return pos;
+      }
+    }
+    return kNotFound;
+  }
+  size_t found =
+      TwoWay(Text<true>(haystack, haystack_size), haystack_size,
+             Text<true>(needle, needle_size), needle_size);
+  return (found == kNotFound ? kNotFound
+                             : haystack_size - needle_size - found);
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <string.h>
+
+// Substring search engine behind StringView/String Find, RFind, Count and
+// Split. Needles up to kShortNeedle bytes are located with a SIMD filter on
+// their first and last byte (AVX2 when the CPU has it, SSE2 otherwise),
+// longer ones with the linear-time Two-Way algorithm.
+//
+// Both functions return the position of the first (last) occurrence of the
+// needle, or static_cast<size_t>(-1) if there is none.
+
+const size_t kShortNeedle = 32;
+
+size_t FindSubstring(const char* haystack, size_t haystack_size,
+                     const char* needle, size_t needle_size);
+
+size_t RFindSubstring(const char* haystack, size_t haystack_size,
+                      const char* needle, size_t needle_size);
@@ -0,0 +1,256 @@
+#include "StringSort.hpp"
+
+#include <algorithm>
+#include <bit>
+
+namespace {
+
+// Ranges this small are finished with insertion sort.
+const size_t kInsertionSort = 16;
+
+// Below this many strings per task splitting into buckets does not pay.
+const size_t kMinParallelSort = 1 << 16;
+
+// Samples drawn per bucket when choosing the splitters.
+const size_t kOversampling = 32;
+
+const size_t kKeyBytes = sizeof(uint64_t);
+
+struct Entry {
+  // Bytes [depth, depth + 8) of the string as a big-endian number, zero
+  // padded past its end, for the depth of the range the entry is in.
+  uint64_t key;
+  const char* data;
+  size_t size;
+  size_t index;
+};
+
+StringView View(const Entry& entry) { return {entry.data, entry.size}; }
+
+uint64_t LoadKey(const Entry& entry, size_t depth) {
+  uint64_t key = 0;
+  if (entry.size >= depth + kKeyBytes) {
+    memcpy(&key, entry.data + depth, kKeyBytes);
+  } else if (entry.size > depth) {
+    memcpy(&key, entry.data + depth, entry.size - depth);
+  }
+  if constexpr (std::endian::native == std::endian::little) {
+    key = __builtin_bswap64(key);
+  }
+  return key;
+}
+
+// All strings of a range share their first depth bytes, so ties on the
+// key are broken by comparing from there.
+bool Less(const Entry& first, const Entry& second, size_t depth) {
+  if (first.key != second.key) {
+    return first.key < second.key;
+  }
+  return View(first).Substr(depth, StringView::kNpos) <
+         View(second).Substr(depth, StringView::kNpos);
+}
+
+void InsertionSort(Entry* begin, Entry* end, size_t depth) {
+  for (Entry* cur = begin; cur != end; ++cur) {
+    Entry entry = *cur;
+    Entry* pos = cur;
+    while (pos != begin && Less(entry, pos[-1], depth)) {
+      *pos = pos[-1];
+      --pos;
+    }
+    *pos = entry;
+  }
+}
+
+uint64_t MedianOfThree(uint64_t a, uint64_t b, uint64_t c) {
+  return std::max(std::min(a, b), std::min(std::max(a, b), c));
+}
+
+// Multikey quicksort (Bentley and Sedgewick) on eight-byte keys. The keys
+// of [begin, end) are loaded for depth.
+void MultikeySort(Entry* begin, Entry* end, size_t depth) {
+  while (end - begin > static_cast<ptrdiff_t>(kInsertionSort)) {
+    uint64_t pivot =
+        MedianOfThree(begin->key, begin[(end - begin) / 2].key, end[-1].key);
+    // [begin, less) < pivot, [less, cur) == pivot, [greater, end) > pivot.
+    Entry* less = begin;
+    Entry* cur = begin;
+    Entry* greater = end;
+    while (cur != greater) {
+      if (cur->key < pivot) {
+        std::swap(*less++, *cur++);
+      } else if (cur->key > pivot) {
+        std::swap(*cur, *--greater);
+      } else {
+        ++cur;
+      }
+    }
+    MultikeySort(begin, less, depth);
+    MultikeySort(greater, end, depth);
+
+    // The strings equal to the pivot agree on the next eight bytes. Those
+    // that end within them are prefixes of each other and of the rest, so
+    // they go first, ordered by length; the rest move on to the next key.
+    Entry* rest = std::partition(less, greater, [depth](const Entry& entry) {
+      return entry.size <= depth + kKeyBytes;
+    });
+    std::sort(less, rest, [](const Entry& first, const Entry& second) {
+      return first.size < second.size;
+    });
+    depth += kKeyBytes;
+    for (Entry* entry = rest; entry != greater; ++entry) {
+      entry->key = LoadKey(*entry, depth);
+    }
+    begin = rest;
+    end = greater;
+  }
+  InsertionSort(begin, end, depth);
+}
+
+size_t TaskCount(const IExecutor& executor, size_t count) {
+  return std::clamp<size_t>(count / kMinParallelSort, 1,
+                            executor.Concurrency());
+}
+
+// Runs fn(task, begin, end) over tasks consecutive slices of [0, count).
+template <typename Function>
+void ForEachSlice(const IExecutor& executor, size_t tasks, size_t count,
+                  Function fn) {
+  size_t slice = count / tasks;
+  executor.Run(tasks, [&](size_t task) {
+    fn(task, task * slice, (task + 1 == tasks ? count : (task + 1) * slice));
+  });
+}
+
+// Parallel sample sort: tasks - 1 splitters picked from a sorted sample
+// cut the input into buckets, every task counts and then scatters its
+// slice into the buckets, and the buckets are sorted concurrently.
+void SampleSort(std::vector<Entry>& entries, size_t tasks,
+                const IExecutor& executor) {
+  size_t count = entries.size();
+  std::vector<Entry> sample;
+  size_t step = count / (tasks * kOversampling);
+  for (size_t i = 0; i < tasks * kOversampling; ++i) {
+    sample.push_back(entries[i * step + step / 2]);
+  }
+  MultikeySort(sample.data(), sample.data() + sample.size(), 0);
+  std::vector<StringView> splitters;
+  for (size_t bucket = 1; bucket < tasks; ++bucket) {
+    splitters.push_back(View(sample[bucket * kOversampling]));
+  }
+
+  std::vector<uint32_t> buckets(count);
+  // counts[task * tasks + bucket], turned into scatter positions below.
+  std::vector<size_t> counts(tasks * tasks, 0);
+  ForEachSlice(executor, tasks, count, [&](size_t task, size_t begin,
+                                           size_t end) {
+    size_t* task_counts = counts.data() + task * tasks;
+    for (size_t i = begin; i < end; ++i) {
+      buckets[i] = std::upper_bound(splitters.begin(), splitters.end(),
+                                    View(entries[i])) -
+                   splitters.begin();
+      ++task_counts[buckets[i]];
+    }
+  });
+  std::vector<size_t> bucket_begin(tasks + 1, count);
+  size_t offset = 0;
+  for (size_t bucket = 0; bucket < tasks; ++bucket) {
+    bucket_begin[bucket] = offset;
+    for (size_t task = 0; task < tasks; ++task) {
+      size_t bucket_count = counts[task * tasks + bucket];
+      counts[task * tasks + bucket] = offset;
+      offset += bucket_count;
+    }
+  }
+
+  std::vector<Entry> sorted(count);
+  ForEachSlice(executor, tasks, count, [&](size_t task, size_t begin,
+                                           size_t end) {
+    size_t* positions = counts.data() + task * tasks;
+    for (size_t i = begin; i < end; ++i) {
+      sorted[positions[buckets[i]]++] = entries[i];
+    }
+  });
+  executor.Run(tasks, [&](size_t bucket) {
+    MultikeySort(sorted.data() + bucket_begin[bucket],
+                 sorted.data() + bucket_begin[bucket + 1], 0);
+  });
+  entries.swap(sorted);
+}
+
+template <typename Piece>
+std::vector<Entry> SortedEntries(std::span<const Piece> strings,
+                                 const IExecutor& executor) {
+  size_t count = strings.size();
+  size_t tasks = TaskCount(executor, count);
+  std::vector<Entry> entries(count);
+  ForEachSlice(executor, tasks, count, [&](size_t /*task*/, size_t begin,
+                                           size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+      StringView view = strings[i];
+      entries[i] = {0, view.Data(), view.Size(), i};
+      entries[i].key = LoadKey(entries[i], 0);
+    }
+  });
+  if (tasks == 1) {
+    MultikeySort(entries.data(), entries.data() + count, 0);
+  } else {
+    SampleSort(entries, tasks, executor);
+  }
+  return entries;
+}
+
+template <typename Piece>
+std::vector<size_t> Indices(std::span<const Piece> strings,
+                            const IExecutor& executor) {
+  std::vector<Entry> entries = SortedEntries(strings, executor);
+  std::vector<size_t> indices(entries.size());
+  for (size_t i = 0; i < entries.size(); ++i) {
+    indices[i] = entries[i].index;
+  }
+  return indices;
+}
+
+}  // namespace
+
+void SortStrings(std::vector<String>& strings, const IExecutor& executor) {
+  std::vector<Entry> entries =
+      SortedEntries(std::span<const String>(strings), executor);
+  // Move construction keeps the memory resource of every string, move
+  // assignment into a default String would copy those from other ones.
+  std::vector<String> sorted;
+  sorted.reserve(strings.size());
+  for (const Entry& entry : entries) {
+    sorted.emplace_back(std::move(strings[entry.index]));
+  }
+  strings.swap(sorted);
+}
+
+void SortStrings(std::vector<StringView>& views, const IExecutor& executor) {
+  std::vector<Entry> entries =
+      SortedEntries(std::span<const StringView>(views), executor);
+  for (size_t i = 0; i < entries.size(); ++i) {
+    views[i] = View(entries[i]);
+  }
+}
+
+std::vector<size_t> SortedIndices(std::span<const String> strings,
+                                  const IExecutor& executor) {
+  return Indices(strings, executor);
+}
+
+std::vector<size_t> SortedIndices(std::span<const StringView> views,
+                                  const IExecutor& executor) {
+  return Indices(views, executor);
+}
+
+void UniqueStrings(std::vector<String>& strings, const IExecutor& executor) {
+  SortStrings(strings, executor);
+  strings.erase(std::unique(strings.begin(), strings.end()), strings.end());
+}
+
+void UniqueStrings(std::vector<StringView>& views,
+                   const IExecutor& executor) {
+  SortStrings(views, executor);
+  views.erase(std::unique(views.begin(), views.end()), views.end());
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <span>
+#include <vector>
+
+#include "String.hpp"
+#include "StringParallel.hpp"
+
+// Sorting into the order of operator<, specialized for strings. The keys
+// are compared eight bytes at a time as big-endian integers cached next
+// to each string (multikey quicksort), so a common prefix is read once
+// per level instead of once per comparison, and lengths are known
+// up front. Equal strings may end up in any order.
+//
+// The executor splits the input into buckets by sampled splitters and
+// sorts the buckets concurrently; inputs under 64K strings per task are
+// sorted serially. The default sorts on the calling thread.
+
+void SortStrings(std::vector<String>& strings,
+                 const IExecutor& executor = ThreadExecutor(1));
+
+// Sorts the views themselves; the characters are not touched.
+void SortStrings(std::vector<StringView>& views,
+                 const IExecutor& executor = ThreadExecutor(1));
+
+// Leaves strings in place and returns the permutation that sorts them:
+// strings[res[0]] <= strings[res[1]] <= ...
+[[nodiscard]] std::vector<size_t> SortedIndices(
+    std::span<const String> strings,
+    const IExecutor& executor = ThreadExecutor(1));
+
+[[nodiscard]] std::vector<size_t> SortedIndices(
+    std::span<const StringView> views,
+    const IExecutor& executor = ThreadExecutor(1));
+
+// Sorts and keeps one copy of every distinct string.
+void UniqueStrings(std::vector<String>& strings,
+                   const IExecutor& executor = ThreadExecutor(1));
+
+void UniqueStrings(std::vector<StringView>& views,
+                   const IExecutor& executor = ThreadExecutor(1));
@@ -0,0 +1,17 @@
+#include "StringStats.hpp"
+
+#ifdef STRING_STATS
+
+thread_local StringStats string_stats::counters;
+
+StringStats GetStringStats() { return string_stats::counters; }
+
+void ResetStringStats() { string_stats::counters = StringStats(); }
+
+#else
+
+StringStats GetStringStats() { return {}; }
+
+void ResetStringStats() {}
+
+#endif
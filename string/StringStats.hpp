@@ -0,0 +1,82 @@
+#pragma once
+
+#include <stddef.h>
+
+// Per-thread counters of the memory traffic caused by String. They are
+// compiled in only when STRING_STATS is defined (cmake -DSTRING_STATS=ON);
+// otherwise every hook below is an empty inline function and
+// GetStringStats() returns zeros.
+struct StringStats {
+  // Bucket i counts strings whose capacity was in [2^(i-1), 2^i) when they
+  // were destroyed or shrunk; bucket 0 is capacity 0.
+  static const size_t kHistogramBuckets = 65;
+
+  size_t allocations = 0;
+  size_t reallocations = 0;
+  size_t deallocations = 0;
+  size_t bytes_allocated = 0;
+  // memcpy'd by String itself; a realloc counts as moving the live bytes.
+  size_t bytes_copied = 0;
+  size_t bytes_zeroed = 0;
+  size_t push_back_growths = 0;
+  size_t capacity_histogram[kHistogramBuckets] = {};
+};
+
+// Counters of the calling thread.
+StringStats GetStringStats();
+
+void ResetStringStats();
+
+namespace string_stats {
+
+#ifdef STRING_STATS
+
+extern thread_local StringStats counters;
+
+inline void OnAllocate(size_t bytes) {
+  ++counters.allocations;
+  counters.bytes_allocated += bytes;
+}
+
+inline void OnReallocate(size_t old_bytes, size_t new_bytes,
+                         size_t live_bytes) {
+  ++counters.reallocations;
+  if (new_bytes > old_bytes) {
+    counters.bytes_allocated += new_bytes - old_bytes;
+  }
+  counters.bytes_copied += live_bytes;
+}
+
+inline void OnDeallocate() { ++counters.deallocations; }
+
+inline void OnCopy(size_t bytes) { counters.bytes_copied += bytes; }
+
+inline void OnZero(size_t bytes) { counters.bytes_zeroed += bytes; }
+
+inline void OnPushBackGrowth() { ++counters.push_back_growths; }
+
+inline void OnRelease(size_t capacity) {
+  size_t bucket = (capacity == 0 ? 0 : 64 - __builtin_clzll(capacity));
+  ++counters.capacity_histogram[bucket];
+}
+
+#else
+
+inline void OnAllocate(size_t /*bytes*/) {}
+
+inline void OnReallocate(size_t /*old_bytes*/, size_t /*new_bytes*/,
+                         size_t /*live_bytes*/) {}
+
+inline void OnDeallocate() {}
+
+inline void OnCopy(size_t /*bytes*/) {}
+
+inline void OnZero(size_t /*bytes*/) {}
+
+inline void OnPushBackGrowth() {}
+
+inline void OnRelease(size_t /*capacity*/) {}
+
+#endif
+
+}  // namespace string_stats
@@ -0,0 +1,217 @@
+#include "StringView.hpp"
+
+#include "StringHash.hpp"
+#include "StringSearch.hpp"
+
+StringView::StringView() : data_(""), size_(0) {}
+
+StringView::StringView(const char* data) : data_(data), size_(strlen(data)) {}
+
+StringView::StringView(const char* data, size_t size)
+    : data_(data), size_(size) {}
+
+char StringView::operator[](size_t index) const { return data_[index]; }
+
+char StringView::Front() const { return data_[0]; }
+
+char StringView::Back() const { return data_[size_ - 1]; }
+
+bool StringView::Empty() const { return (size_ == 0); }
+
+size_t StringView::Size() const { return size_; }
+
+const char* StringView::Data() const { return data_; }
+
+StringView StringView::Substr(size_t pos, size_t count) const {
+  if (pos > size_) {
+    pos = size_;
+  }
+  if (count > size_ - pos) {
+    count = size_ - pos;
+  }
+  return {data_ + pos, count};
+}
+
+void StringView::RemovePrefix(size_t count) {
+  data_ += count;
+  size_ -= count;
+}
+
+void StringView::RemoveSuffix(size_t count) { size_ -= count; }
+
+size_t StringView::Find(StringView needle, size_t pos) const {
+  if (pos > size_) {
+    return kNpos;
+  }
+  size_t found =
+      FindSubstring(data_ + pos, size_ - pos, needle.data_, needle.size_);
+  return (found == kNpos ? kNpos : pos + found);
+}
+
+size_t StringView::RFind(StringView needle, size_t pos) const {
+  if (needle.size_ > size_) {
+    return kNpos;
+  }
+  if (pos > size_ - needle.size_) {
+    pos = size_ - needle.size_;
+  }
+  return RFindSubstring(data_, pos + needle.size_, needle.data_,
+                        needle.size_);
+}
+
+bool StringView::Contains(StringView needle) const {
+  return Find(needle) != kNpos;
+}
+
+size_t StringView::Count(StringView needle) const {
+  if (needle.Empty()) {
+    return size_ + 1;
+  }
+  size_t count = 0;
+  for (size_t pos = Find(needle); pos != kNpos;
+       pos = Find(needle, pos + needle.size_)) {
+    ++count;
+  }
+  return count;
+}
+
+bool StringView::StartsWith(StringView prefix) const {
+  return prefix.size_ <= size_ &&
+         memcmp(data_, prefix.data_, prefix.size_) == 0;
+}
+
+bool StringView::EndsWith(StringView suffix) const {
+  return suffix.size_ <= size_ &&
+         memcmp(data_ + size_ - suffix.size_, suffix.data_, suffix.size_) == 0;
+}
+
+int StringView::Compare(StringView other) const {
+  size_t common = (size_ < other.size_ ? size_ : other.size_);
+  int res = (common != 0 ? memcmp(data_, other.data_, common) : 0);
+  if (res != 0) {
+    return res;
+  }
+  if (size_ == other.size_) {
+    return 0;
+  }
+  return (size_ < other.size_ ? -1 : 1);
+}
+
+bool StringView::ParseDouble(double& value) const {
+  double parsed;
+  auto [end, error] = std::from_chars(data_, data_ + size_, parsed);
+  if (error != std::errc() || end != data_ + size_) {
+    return false;
+  }
+  value = parsed;
+  return true;
+}
+
+size_t StringView::Hash() const {
+  return HashBytes(data_, size_);
+}
+
+std::vector<StringView> StringView::Split(StringView delim) const {
+  std::vector<StringView> tokens;
+  for (StringView token : SplitLazy(delim)) {
+    tokens.push_back(token);
+  }
+  return tokens;
+}
+
+SplitRange StringView::SplitLazy(StringView delim, size_t max_split) const {
+  return {*this, delim, max_split};
+}
+
+SplitRange::Iterator::Iterator()
+    : splits_left_(0), has_rest_(false), done_(true) {}
+
+// An empty delimiter never matches, so the whole source is a single token.
+SplitRange::Iterator::Iterator(StringView source, StringView delim,
+                               size_t max_split)
+    : rest_(source),
+      delim_(delim),
+      splits_left_(delim.Empty() ? 0 : max_split),
+      has_rest_(true),
+      done_(false) {
+  FindNext();
+}
+
+StringView SplitRange::Iterator::operator*() const { return token_; }
+
+SplitRange::Iterator& SplitRange::Iterator::operator++() {
+  FindNext();
+  return *this;
+}
+
+SplitRange::Iterator SplitRange::Iterator::operator++(int) {
+  Iterator copy(*this);
+  FindNext();
+  return copy;
+}
+
+bool SplitRange::Iterator::operator==(const Iterator& other) const {
+  return done_ == other.done_ &&
+         (done_ || token_.Data() == other.token_.Data());
+}
+
+bool SplitRange::Iterator::operator==(std::default_sentinel_t) const {
+  return done_;
+}
+
+void SplitRange::Iterator::FindNext() {
+  if (!has_rest_) {
+    done_ = true;
+    return;
+  }
+  size_t pos = (splits_left_ != 0 ? rest_.Find(delim_) : StringView::kNpos);
+  if (pos == StringView::kNpos) {
+    token_ = rest_;
+    has_rest_ = false;
+  } else {
+    token_ = rest_.Substr(0, pos);
+    rest_.RemovePrefix(pos + delim_.Size());
+    --splits_left_;
+  }
+}
+
+SplitRange::SplitRange() : max_split_(0) {}
+
+SplitRange::SplitRange(StringView source, StringView delim, size_t max_split)
+    : source_(source), delim_(delim), max_split_(max_split) {}
+
+SplitRange::Iterator SplitRange::begin() const {
+  return {source_, delim_, max_split_};
+}
+
+SplitRange::Iterator SplitRange::end() const { return {}; }
+
+std::ostream& operator<<(std::ostream& out, StringView view) {
+  out.write(view.Data(), view.Size());
+  return out;
+}
+
+bool operator<(StringView first, StringView second) {
+  return first.Compare(second) < 0;
+}
+
+bool operator>(StringView first, StringView second) {
+  return first.Compare(second) > 0;
+}
+
+bool operator<=(StringView first, StringView second) {
+  return first.Compare(second) <= 0;
+}
+
+bool operator>=(StringView first, StringView second) {
+  return first.Compare(second) >= 0;
+}
+
+bool operator==(StringView first, StringView second) {
+  return first.Size() == second.Size() &&
+         memcmp(first.Data(), second.Data(), first.Size()) == 0;
+}
+
+bool operator!=(StringView first, StringView second) {
+  return !(first == second);
+}
@@ -0,0 +1,168 @@
+#pragma once
+
+#include <string.h>
+
+#include <charconv>
+#include <concepts>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <ranges>
+#include <vector>
+
+class SplitRange;
+
+// Non-owning view of a character range, usually a slice of a String. The
+// viewed characters must outlive the view and are not NUL-terminated.
+class StringView {
+ public:
+  static const size_t kNpos = -1;
+
+  StringView();
+
+  StringView(const char* data);
+
+  StringView(const char* data, size_t size);
+
+  char operator[](size_t index) const;
+
+  [[nodiscard]] char Front() const;
+
+  [[nodiscard]] char Back() const;
+
+  [[nodiscard]] bool Empty() const;
+
+  [[nodiscard]] size_t Size() const;
+
+  [[nodiscard]] const char* Data() const;
+
+  [[nodiscard]] StringView Substr(size_t pos, size_t count) const;
+
+  void RemovePrefix(size_t count);
+
+  void RemoveSuffix(size_t count);
+
+  // Position of the first occurrence of needle starting at or after pos,
+  // kNpos if there is none.
+  [[nodiscard]] size_t Find(StringView needle, size_t pos = 0) const;
+
+  // Position of the last occurrence of needle starting at or before pos,
+  // kNpos if there is none.
+  [[nodiscard]] size_t RFind(StringView needle, size_t pos = kNpos) const;
+
+  [[nodiscard]] bool Contains(StringView needle) const;
+
+  // Number of non-overlapping occurrences, counted left to right.
+  [[nodiscard]] size_t Count(StringView needle) const;
+
+  [[nodiscard]] bool StartsWith(StringView prefix) const;
+
+  [[nodiscard]] bool EndsWith(StringView suffix) const;
+
+  [[nodiscard]] int Compare(StringView other) const;
+
+  // The whole view must be a number in the syntax of std::from_chars (no
+  // leading whitespace or '+'). On success stores it and returns true;
+  // otherwise, including on overflow, leaves value unchanged.
+  template <std::integral Int>
+  [[nodiscard]] bool ParseInt(Int& value, int base = 10) const;
+
+  [[nodiscard]] bool ParseDouble(double& value) const;
+
+  [[nodiscard]] size_t Hash() const;
+
+  [[nodiscard]] std::vector<StringView> Split(StringView delim = " ") const;
+
+  // Lazy form of Split: tokens are found one at a time while iterating.
+  // After max_split delimiters the rest of the view is the last token.
+  [[nodiscard]] SplitRange SplitLazy(StringView delim = " ",
+                                     size_t max_split = -1) const;
+
+ private:
+  const char* data_;
+  size_t size_;
+};
+
+template <std::integral Int>
+bool StringView::ParseInt(Int& value, int base) const {
+  Int parsed;
+  auto [end, error] = std::from_chars(data_, data_ + size_, parsed, base);
+  if (error != std::errc() || end != data_ + size_) {
+    return false;
+  }
+  value = parsed;
+  return true;
+}
+
+class SplitRange : public std::ranges::view_interface<SplitRange> {
+ public:
+  class Iterator {
+   public:
+    using value_type = StringView;
+    using reference = StringView;
+    using difference_type = ptrdiff_t;
+    using iterator_category = std::input_iterator_tag;
+    using iterator_concept = std::forward_iterator_tag;
+
+    Iterator();
+
+    StringView operator*() const;
+
+    Iterator& operator++();
+
+    Iterator operator++(int);
+
+    bool operator==(const Iterator& other) const;
+
+    bool operator==(std::default_sentinel_t) const;
+
+   private:
+    friend class SplitRange;
+
+    Iterator(StringView source, StringView delim, size_t max_split);
+
+    void FindNext();
+
+    StringView token_;
+    StringView rest_;
+    StringView delim_;
+    size_t splits_left_;
+    bool has_rest_;
+    bool done_;
+  };
+
+  SplitRange();
+
+  SplitRange(StringView source, StringView delim, size_t max_split);
+
+  [[nodiscard]] Iterator begin() const;
+
+  [[nodiscard]] Iterator end() const;
+
+ private:
+  StringView source_;
+  StringView delim_;
+  size_t max_split_;
+};
+
+template <>
+inline constexpr bool std::ranges::enable_borrowed_range<SplitRange> = true;
+
+std::ostream& operator<<(std::ostream& out, StringView view);
+
+bool operator<(StringView first, StringView second);
+
+bool operator>(StringView first, StringView second);
+
+bool operator<=(StringView first, StringView second);
+
+bool operator>=(StringView first, StringView second);
+
+bool operator==(StringView first, StringView second);
+
+bool operator!=(StringView first, StringView second);
+
+template <>
+struct std::hash<StringView> {
+  size_t operator()(StringView view) const { return view.Hash(); }
+};
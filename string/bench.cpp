@@ -0,0 +1,689 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <ranges>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Arena.hpp"
+#include "FixedString.hpp"
+#include "Rope.hpp"
+#include "SharedString.hpp"
+#include "String.hpp"
+#include "StringBuilder.hpp"
+#include "StringParallel.hpp"
+#include "StringSort.hpp"
+
+namespace {
+
+std::string MakeLine(size_t fields, const std::string& delim) {
+  std::string line;
+  for (size_t i = 0; i < fields; i++) {
+    if (i != 0) {
+      line += delim;
+    }
+    line += "field" + std::to_string(i * 7919 % 1000);
+  }
+  return line;
+}
+
+std::vector<std::string> SplitStd(const std::string& str,
+                                  const std::string& delim) {
+  std::vector<std::string> tokens;
+  size_t begin = 0;
+  for (size_t pos = str.find(delim); pos != std::string::npos;
+       pos = str.find(delim, begin)) {
+    tokens.push_back(str.substr(begin, pos - begin));
+    begin = pos + delim.size();
+  }
+  tokens.push_back(str.substr(begin));
+  return tokens;
+}
+
+std::string JoinStd(const std::string& sep,
+                    const std::vector<std::string>& strings) {
+  std::string res;
+  for (size_t i = 0; i < strings.size(); i++) {
+    if (i != 0) {
+      res += sep;
+    }
+    res += strings[i];
+  }
+  return res;
+}
+
+const char* Literal(int64_t size) {
+  static const std::string kLong(1 << 16, 'x');
+  return kLong.c_str() + kLong.size() - size;
+}
+
+// URL-like keys with long shared prefixes, about half of them repeated.
+std::vector<String> MakeKeys(size_t count) {
+  std::vector<String> keys;
+  for (size_t i = 0; i < count; i++) {
+    size_t id = i * 2654435761u % (count / 2 + 1);
+    keys.emplace_back(
+        ("https://example.com/users/" + std::to_string(id % 97) + "/items/" +
+         std::to_string(id))
+            .c_str());
+  }
+  return keys;
+}
+
+// Rope("text") must compile, and Chunks() must be a range the standard
+// algorithms accept; the chunks add up to the whole text.
+static_assert(std::ranges::input_range<Rope::ChunkRange>);
+
+bool RopeChunksMatch() {
+  Rope rope("literal, ");
+  for (int i = 0; i < 1000; i++) {
+    rope += StringView("piece, ");
+  }
+  size_t size = 0;
+  std::ranges::for_each(rope.Chunks(),
+                        [&size](StringView chunk) { size += chunk.Size(); });
+  return size == rope.Size() && rope.Flatten().Size() == rope.Size();
+}
+
+// A reference from the non-const operator[] may write at any later time,
+// so a copy made after it was taken must not see the write.
+bool EscapedReferenceIsNotShared() {
+  SharedString original(StringView("shared payload"));
+  char& first = original[0];
+  SharedString copy(original);
+  first = 'J';
+  return std::as_const(copy)[0] == 's' && std::as_const(original)[0] == 'J';
+}
+
+}  // namespace
+
+//////////////////////////////////Construction//////////////////////////////////
+void BM_Construct_String(benchmark::State& state) {
+  const char* literal = Literal(state.range(0));
+  for (auto _ : state) {
+    String str(literal);
+    benchmark::DoNotOptimize(str.Data());
+  }
+}
+BENCHMARK(BM_Construct_String)->Arg(8)->Arg(15)->Arg(64)->Arg(4096);
+
+void BM_Construct_Std(benchmark::State& state) {
+  const char* literal = Literal(state.range(0));
+  for (auto _ : state) {
+    std::string str(literal);
+    benchmark::DoNotOptimize(str.data());
+  }
+}
+BENCHMARK(BM_Construct_Std)->Arg(8)->Arg(15)->Arg(64)->Arg(4096);
+
+////////////////////////////////////PushBack////////////////////////////////////
+void BM_PushBack_String(benchmark::State& state) {
+  for (auto _ : state) {
+    String str;
+    for (int64_t i = 0; i < state.range(0); i++) {
+      str.PushBack('a' + i % 26);
+    }
+    benchmark::DoNotOptimize(str.Data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_PushBack_String)->Range(16, 1 << 20);
+
+void BM_PushBack_Std(benchmark::State& state) {
+  for (auto _ : state) {
+    std::string str;
+    for (int64_t i = 0; i < state.range(0); i++) {
+      str.push_back('a' + i % 26);
+    }
+    benchmark::DoNotOptimize(str.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_PushBack_Std)->Range(16, 1 << 20);
+
+///////////////////////////////////Concatenation////////////////////////////////
+void BM_AppendAssign_String(benchmark::State& state) {
+  String piece(Literal(state.range(0)));
+  for (auto _ : state) {
+    String str;
+    for (int i = 0; i < 1000; i++) {
+      str += piece;
+    }
+    benchmark::DoNotOptimize(str.Data());
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0) * 1000);
+}
+BENCHMARK(BM_AppendAssign_String)->Arg(8)->Arg(64)->Arg(1024);
+
+void BM_AppendAssign_Std(benchmark::State& state) {
+  std::string piece(Literal(state.range(0)));
+  for (auto _ : state) {
+    std::string str;
+    for (int i = 0; i < 1000; i++) {
+      str += piece;
+    }
+    benchmark::DoNotOptimize(str.data());
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0) * 1000);
+}
+BENCHMARK(BM_AppendAssign_Std)->Arg(8)->Arg(64)->Arg(1024);
+
+void BM_Plus_String(benchmark::State& state) {
+  String a(Literal(state.range(0)));
+  String b(Literal(state.range(0)));
+  for (auto _ : state) {
+    String str = a + b + a + b;
+    benchmark::DoNotOptimize(str.Data());
+  }
+}
+BENCHMARK(BM_Plus_String)->Arg(4)->Arg(64)->Arg(4096);
+
+void BM_Plus_Std(benchmark::State& state) {
+  std::string a(Literal(state.range(0)));
+  std::string b(Literal(state.range(0)));
+  for (auto _ : state) {
+    std::string str = a + b + a + b;
+    benchmark::DoNotOptimize(str.data());
+  }
+}
+BENCHMARK(BM_Plus_Std)->Arg(4)->Arg(64)->Arg(4096);
+
+void BM_Multiply_String(benchmark::State& state) {
+  String piece("abcdefg");
+  for (auto _ : state) {
+    String str = piece * state.range(0);
+    benchmark::DoNotOptimize(str.Data());
+  }
+}
+BENCHMARK(BM_Multiply_String)->Range(8, 1 << 16);
+
+void BM_Multiply_Std(benchmark::State& state) {
+  std::string piece("abcdefg");
+  for (auto _ : state) {
+    std::string str;
+    str.reserve(piece.size() * state.range(0));
+    for (int64_t i = 0; i < state.range(0); i++) {
+      str += piece;
+    }
+    benchmark::DoNotOptimize(str.data());
+  }
+}
+BENCHMARK(BM_Multiply_Std)->Range(8, 1 << 16);
+
+///////////////////////////////////Split / Join/////////////////////////////////
+// Arguments: number of fields, delimiter length.
+void BM_Split_String(benchmark::State& state) {
+  std::string delim(state.range(1), ',');
+  String line(MakeLine(state.range(0), delim).c_str());
+  String str_delim(delim.c_str());
+  for (auto _ : state) {
+    std::vector<String> tokens = line.Split(str_delim);
+    benchmark::DoNotOptimize(tokens.data());
+  }
+  state.SetBytesProcessed(state.iterations() * line.Size());
+}
+BENCHMARK(BM_Split_String)
+    ->ArgsProduct({{16, 1024, 65536}, {1, 3, 40}});
+
+void BM_SplitView_String(benchmark::State& state) {
+  std::string delim(state.range(1), ',');
+  String line(MakeLine(state.range(0), delim).c_str());
+  for (auto _ : state) {
+    std::vector<StringView> tokens =
+        line.SplitView(StringView(delim.data(), delim.size()));
+    benchmark::DoNotOptimize(tokens.data());
+  }
+  state.SetBytesProcessed(state.iterations() * line.Size());
+}
+BENCHMARK(BM_SplitView_String)
+    ->ArgsProduct({{16, 1024, 65536}, {1, 3, 40}});
+
+// Same lines as BM_SplitView_String with the delimiter as a template
+// argument; the second argument is the delimiter length.
+template <FixedString Delim>
+void BM_SplitView_Fixed(benchmark::State& state) {
+  std::string delim(Delim.Data(), Delim.Size());
+  String line(MakeLine(state.range(0), delim).c_str());
+  for (auto _ : state) {
+    std::vector<StringView> tokens = SplitView<Delim>(line);
+    benchmark::DoNotOptimize(tokens.data());
+  }
+  state.SetBytesProcessed(state.iterations() * line.Size());
+}
+BENCHMARK(BM_SplitView_Fixed<",">)->ArgsProduct({{16, 1024, 65536}, {1}});
+BENCHMARK(BM_SplitView_Fixed<",,,">)->ArgsProduct({{16, 1024, 65536}, {3}});
+
+void BM_Split_Std(benchmark::State& state) {
+  std::string delim(state.range(1), ',');
+  std::string line = MakeLine(state.range(0), delim);
+  for (auto _ : state) {
+    std::vector<std::string> tokens = SplitStd(line, delim);
+    benchmark::DoNotOptimize(tokens.data());
+  }
+  state.SetBytesProcessed(state.iterations() * line.size());
+}
+BENCHMARK(BM_Split_Std)->ArgsProduct({{16, 1024, 65536}, {1, 3, 40}});
+
+void BM_Join_String(benchmark::State& state) {
+  std::vector<String> fields =
+      String(MakeLine(state.range(0), ",").c_str()).Split(",");
+  String sep(", ");
+  for (auto _ : state) {
+    String str = sep.Join(fields);
+    benchmark::DoNotOptimize(str.Data());
+  }
+}
+BENCHMARK(BM_Join_String)->Range(16, 1 << 16);
+
+void BM_Join_Std(benchmark::State& state) {
+  std::vector<std::string> fields =
+      SplitStd(MakeLine(state.range(0), ","), ",");
+  std::string sep(", ");
+  for (auto _ : state) {
+    std::string str = JoinStd(sep, fields);
+    benchmark::DoNotOptimize(str.data());
+  }
+}
+BENCHMARK(BM_Join_Std)->Range(16, 1 << 16);
+
+// Scaling of the parallel variants over a 64 MB line; the argument is the
+// thread count and 1 thread is the serial baseline.
+const size_t kParallelFields = 8 << 20;
+
+void BM_ParallelSplit_String(benchmark::State& state) {
+  String line(MakeLine(kParallelFields, ",").c_str());
+  for (auto _ : state) {
+    std::vector<String> tokens = ParallelSplit(line, ",", state.range(0));
+    benchmark::DoNotOptimize(tokens.data());
+  }
+  state.SetBytesProcessed(state.iterations() * line.Size());
+}
+BENCHMARK(BM_ParallelSplit_String)
+    ->RangeMultiplier(2)
+    ->Range(1, 16)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+void BM_ParallelSplitView_String(benchmark::State& state) {
+  String line(MakeLine(kParallelFields, ",").c_str());
+  for (auto _ : state) {
+    std::vector<StringView> tokens =
+        ParallelSplitView(line, ",", state.range(0));
+    benchmark::DoNotOptimize(tokens.data());
+  }
+  state.SetBytesProcessed(state.iterations() * line.Size());
+}
+BENCHMARK(BM_ParallelSplitView_String)
+    ->RangeMultiplier(2)
+    ->Range(1, 16)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+void BM_ParallelJoin_String(benchmark::State& state) {
+  std::vector<String> fields =
+      String(MakeLine(kParallelFields, ",").c_str()).Split(",");
+  size_t bytes = 0;
+  for (auto _ : state) {
+    String str = ParallelJoin(", ", fields, state.range(0));
+    benchmark::DoNotOptimize(str.Data());
+    bytes = str.Size();
+  }
+  state.SetBytesProcessed(state.iterations() * bytes);
+}
+BENCHMARK(BM_ParallelJoin_String)
+    ->RangeMultiplier(2)
+    ->Range(1, 16)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+///////////////////////////////////Comparison///////////////////////////////////
+void BM_Compare_String(benchmark::State& state) {
+  String a(Literal(state.range(0)));
+  String b(a);
+  b.Back() = 'y';
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(a < b);
+    benchmark::DoNotOptimize(a == b);
+  }
+}
+BENCHMARK(BM_Compare_String)->Arg(8)->Arg(64)->Arg(4096);
+
+void BM_Compare_Std(benchmark::State& state) {
+  std::string a(Literal(state.range(0)));
+  std::string b(a);
+  b.back() = 'y';
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(a < b);
+    benchmark::DoNotOptimize(a == b);
+  }
+}
+BENCHMARK(BM_Compare_Std)->Arg(8)->Arg(64)->Arg(4096);
+
+///////////////////////////////////Stream I/O///////////////////////////////////
+void BM_ReadLines_String(benchmark::State& state) {
+  std::string text;
+  for (int64_t i = 0; i < state.range(0); i++) {
+    text += MakeLine(8, " ") + "\n";
+  }
+  for (auto _ : state) {
+    std::istringstream in(text);
+    String line;
+    while (line.ReadLine(in)) {
+      benchmark::DoNotOptimize(line.Data());
+    }
+  }
+  state.SetBytesProcessed(state.iterations() * text.size());
+}
+BENCHMARK(BM_ReadLines_String)->Arg(1 << 14);
+
+void BM_ReadLines_Std(benchmark::State& state) {
+  std::string text;
+  for (int64_t i = 0; i < state.range(0); i++) {
+    text += MakeLine(8, " ") + "\n";
+  }
+  for (auto _ : state) {
+    std::istringstream in(text);
+    std::string line;
+    while (std::getline(in, line)) {
+      benchmark::DoNotOptimize(line.data());
+    }
+  }
+  state.SetBytesProcessed(state.iterations() * text.size());
+}
+BENCHMARK(BM_ReadLines_Std)->Arg(1 << 14);
+
+void BM_Write_String(benchmark::State& state) {
+  String str(Literal(state.range(0)));
+  for (auto _ : state) {
+    std::ostringstream out;
+    for (int i = 0; i < 100; i++) {
+      out << str;
+    }
+    benchmark::DoNotOptimize(out.tellp());
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0) * 100);
+}
+BENCHMARK(BM_Write_String)->Arg(16)->Arg(4096);
+
+void BM_Write_Std(benchmark::State& state) {
+  std::string str(Literal(state.range(0)));
+  for (auto _ : state) {
+    std::ostringstream out;
+    for (int i = 0; i < 100; i++) {
+      out << str;
+    }
+    benchmark::DoNotOptimize(out.tellp());
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0) * 100);
+}
+BENCHMARK(BM_Write_Std)->Arg(16)->Arg(4096);
+
+///////////////////////////////////Sorting//////////////////////////////////////
+// Every iteration sorts a fresh, untimed copy of the keys.
+void BM_Sort_String(benchmark::State& state) {
+  std::vector<String> keys = MakeKeys(state.range(0));
+  for (auto _ : state) {
+    state.PauseTiming();
+    std::vector<String> copy = keys;
+    state.ResumeTiming();
+    SortStrings(copy);
+    benchmark::DoNotOptimize(copy.data());
+  }
+}
+BENCHMARK(BM_Sort_String)
+    ->Range(1 << 10, 1 << 20)
+    ->Unit(benchmark::kMillisecond);
+
+void BM_SortParallel_String(benchmark::State& state) {
+  std::vector<String> keys = MakeKeys(1 << 21);
+  for (auto _ : state) {
+    state.PauseTiming();
+    std::vector<String> copy = keys;
+    state.ResumeTiming();
+    SortStrings(copy, ThreadExecutor(state.range(0)));
+    benchmark::DoNotOptimize(copy.data());
+  }
+}
+BENCHMARK(BM_SortParallel_String)
+    ->RangeMultiplier(2)
+    ->Range(1, 16)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+// The keys live in an arena, which SortStrings must leave them in.
+void BM_Sort_StringArena(benchmark::State& state) {
+  std::vector<String> keys = MakeKeys(state.range(0));
+  Arena arena;
+  for (auto _ : state) {
+    state.PauseTiming();
+    arena.Release();
+    std::vector<String> copy;
+    for (const String& key : keys) {
+      copy.emplace_back(key, &arena);
+    }
+    state.ResumeTiming();
+    SortStrings(copy);
+    benchmark::DoNotOptimize(copy.data());
+    state.PauseTiming();
+    bool kept = std::all_of(copy.begin(), copy.end(), [&](const String& key) {
+      return key.GetResource() == &arena;
+    });
+    state.ResumeTiming();
+    if (!kept || !std::is_sorted(copy.begin(), copy.end())) {
+      state.SkipWithError("SortStrings moved keys out of their arena");
+      return;
+    }
+  }
+}
+BENCHMARK(BM_Sort_StringArena)
+    ->Range(1 << 10, 1 << 20)
+    ->Unit(benchmark::kMillisecond);
+
+void BM_SortViews_String(benchmark::State& state) {
+  std::vector<String> keys = MakeKeys(state.range(0));
+  std::vector<StringView> views(keys.begin(), keys.end());
+  for (auto _ : state) {
+    state.PauseTiming();
+    std::vector<StringView> copy = views;
+    state.ResumeTiming();
+    SortStrings(copy);
+    benchmark::DoNotOptimize(copy.data());
+  }
+}
+BENCHMARK(BM_SortViews_String)
+    ->Range(1 << 10, 1 << 20)
+    ->Unit(benchmark::kMillisecond);
+
+void BM_Sort_StdSort(benchmark::State& state) {
+  std::vector<String> keys = MakeKeys(state.range(0));
+  for (auto _ : state) {
+    state.PauseTiming();
+    std::vector<String> copy = keys;
+    state.ResumeTiming();
+    std::sort(copy.begin(), copy.end());
+    benchmark::DoNotOptimize(copy.data());
+  }
+}
+BENCHMARK(BM_Sort_StdSort)
+    ->Range(1 << 10, 1 << 20)
+    ->Unit(benchmark::kMillisecond);
+
+void BM_Unique_String(benchmark::State& state) {
+  std::vector<String> keys = MakeKeys(state.range(0));
+  for (auto _ : state) {
+    state.PauseTiming();
+    std::vector<String> copy = keys;
+    state.ResumeTiming();
+    UniqueStrings(copy);
+    benchmark::DoNotOptimize(copy.data());
+  }
+}
+BENCHMARK(BM_Unique_String)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+
+void BM_Unique_StdSort(benchmark::State& state) {
+  std::vector<String> keys = MakeKeys(state.range(0));
+  for (auto _ : state) {
+    state.PauseTiming();
+    std::vector<String> copy = keys;
+    state.ResumeTiming();
+    std::sort(copy.begin(), copy.end());
+    copy.erase(std::unique(copy.begin(), copy.end()), copy.end());
+    benchmark::DoNotOptimize(copy.data());
+  }
+}
+BENCHMARK(BM_Unique_StdSort)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+
+///////////////////////////////////Numbers//////////////////////////////////////
+// Formats and parses 1000 coordinate pairs per iteration.
+void BM_FormatInts_String(benchmark::State& state) {
+  for (auto _ : state) {
+    String str;
+    for (int i = 0; i < 1000; i++) {
+      str.AppendInt(i * 7919).PushBack(',');
+      str.AppendInt(-i * 104729).PushBack('\n');
+    }
+    benchmark::DoNotOptimize(str.Data());
+  }
+}
+BENCHMARK(BM_FormatInts_String);
+
+void BM_FormatInts_Builder(benchmark::State& state) {
+  for (auto _ : state) {
+    StringBuilder builder;
+    for (int i = 0; i < 1000; i++) {
+      builder.Append(i * 7919, ',', -i * 104729, '\n');
+    }
+    String str = builder.Release();
+    benchmark::DoNotOptimize(str.Data());
+  }
+}
+BENCHMARK(BM_FormatInts_Builder);
+
+void BM_FormatInts_Std(benchmark::State& state) {
+  for (auto _ : state) {
+    std::string str;
+    for (int i = 0; i < 1000; i++) {
+      str += std::to_string(i * 7919) + "," + std::to_string(-i * 104729) +
+             "\n";
+    }
+    benchmark::DoNotOptimize(str.data());
+  }
+}
+BENCHMARK(BM_FormatInts_Std);
+
+void BM_FormatDoubles_String(benchmark::State& state) {
+  for (auto _ : state) {
+    String str;
+    for (int i = 0; i < 1000; i++) {
+      str.AppendDouble(i * 0.37).PushBack('\n');
+    }
+    benchmark::DoNotOptimize(str.Data());
+  }
+}
+BENCHMARK(BM_FormatDoubles_String);
+
+void BM_FormatDoubles_Std(benchmark::State& state) {
+  for (auto _ : state) {
+    std::string str;
+    for (int i = 0; i < 1000; i++) {
+      str += std::to_string(i * 0.37) + "\n";
+    }
+    benchmark::DoNotOptimize(str.data());
+  }
+}
+BENCHMARK(BM_FormatDoubles_Std);
+
+void BM_ParseInts_String(benchmark::State& state) {
+  String text(MakeLine(1000, ",").c_str());
+  std::vector<StringView> fields = text.SplitView(",");
+  for (StringView& field : fields) {
+    field.RemovePrefix(5);
+  }
+  for (auto _ : state) {
+    int64_t sum = 0;
+    for (StringView field : fields) {
+      int value = 0;
+      if (field.ParseInt(value)) {
+        sum += value;
+      }
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+}
+BENCHMARK(BM_ParseInts_String);
+
+void BM_ParseInts_Std(benchmark::State& state) {
+  std::vector<std::string> fields = SplitStd(MakeLine(1000, ","), ",");
+  for (std::string& field : fields) {
+    field.erase(0, 5);
+  }
+  for (auto _ : state) {
+    int64_t sum = 0;
+    for (const std::string& field : fields) {
+      sum += std::stoi(field);
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+}
+BENCHMARK(BM_ParseInts_Std);
+
+///////////////////////////////////SharedString/////////////////////////////////
+void BM_Copy_SharedString(benchmark::State& state) {
+  if (!EscapedReferenceIsNotShared()) {
+    state.SkipWithError("SharedString copy shares an escaped reference");
+    return;
+  }
+  SharedString str(StringView(Literal(state.range(0))));
+  for (auto _ : state) {
+    SharedString copy(str);
+    benchmark::DoNotOptimize(copy.Data());
+  }
+}
+BENCHMARK(BM_Copy_SharedString)->Arg(8)->Arg(64)->Arg(4096);
+
+void BM_Copy_String(benchmark::State& state) {
+  String str(Literal(state.range(0)));
+  for (auto _ : state) {
+    String copy(str);
+    benchmark::DoNotOptimize(copy.Data());
+  }
+}
+BENCHMARK(BM_Copy_String)->Arg(8)->Arg(64)->Arg(4096);
+
+///////////////////////////////////////Rope/////////////////////////////////////
+// Appends 4096 pieces of the given size, then reads the text back.
+void BM_Append_Rope(benchmark::State& state) {
+  if (!RopeChunksMatch()) {
+    state.SkipWithError("Rope chunks differ from the text");
+    return;
+  }
+  StringView piece(Literal(state.range(0)));
+  for (auto _ : state) {
+    Rope rope;
+    for (int i = 0; i < 4096; i++) {
+      rope += piece;
+    }
+    for (StringView chunk : rope.Chunks()) {
+      benchmark::DoNotOptimize(chunk.Data());
+    }
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0) * 4096);
+}
+BENCHMARK(BM_Append_Rope)->Arg(8)->Arg(64)->Arg(1024);
+
+void BM_Append_String(benchmark::State& state) {
+  String piece(Literal(state.range(0)));
+  for (auto _ : state) {
+    String str;
+    for (int i = 0; i < 4096; i++) {
+      str += piece;
+    }
+    benchmark::DoNotOptimize(str.Data());
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0) * 4096);
+}
+BENCHMARK(BM_Append_String)->Arg(8)->Arg(64)->Arg(1024);
+
+BENCHMARK_MAIN();